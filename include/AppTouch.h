@@ -33,6 +33,12 @@
 #include "cinder/app/TouchEvent.h"
 #include "cinder/app/MouseEvent.h"
 
+#include "TouchHistory.h"
+#include "TouchInputQueue.h"
+#include "PalmRejector.h"
+#include "TouchPoint.h"
+#include "TouchRecorder.h"
+
 namespace Pivot {
 
     class AppTouch : public ci::app::AppNative {
@@ -44,6 +50,43 @@ namespace Pivot {
         virtual void    touchesMoved( ci::app::TouchEvent event ) {}
         virtual void    touchesEnded( ci::app::TouchEvent event ) {}
         virtual void    touchesCancelled( ci::app::TouchEvent event ) {}
+        
+        //! Merges all moves of each touch between frames into a single touchesMoved, delivered just before update(). Merged moves have no native data.
+        void                    enableTouchCoalescing( bool coalesceTouches = true );
+        void                    disableTouchCoalescing() { enableTouchCoalescing( false ); }
+        bool                    isTouchCoalescing() const { return mCoalescingTouches; }
+        //! Every sample of the active touches received while coalescing, including the merged moves
+        const TouchHistory&     getTouchHistory() const { return mTouchHistory; }
+        
+        //! Moves each touch to where it should be once the frame is on screen, \a latency seconds after update(), by extrapolating its
+        //! recent samples. Never reaches more than \a maxHorizon past the newest sample. Negative latencies interpolate, trading lag for smoothness.
+        //! Predicted moves keep the newest sample's time, so touch times never run ahead or step back. They skip the history and recorder. Enables coalescing.
+        void                    enableTouchPrediction( double latency = 0.016, double maxHorizon = 0.032 );
+        void                    disableTouchPrediction();
+        bool                    isTouchPredicting() const { return mPredictingTouches; }
+        
+        //! Queues incoming touches, keeping their platform timestamps, and delivers them just before update(). Keeps input timing intact through slow frames.
+        //! Queued touches have no native data.
+        void                    enableTouchQueue( bool queueTouches = true );
+        void                    disableTouchQueue() { enableTouchQueue( false ); }
+        bool                    isTouchQueueing() const { return mQueueingTouches; }
+        //! Registers an extra queue fed by a thread of its own, such as a network or HID reader. Drained before update() along with the app's own touches.
+        void                    addTouchInput( TouchInputQueue *input );
+        void                    removeTouchInput( TouchInputQueue *input );
+        
+        //! Drops palms, sleeves and forearms before they reach touchesBegan() (see PalmRejector). Rejected touches are never dispatched or recorded,
+        //! and touches that turn out to be the first contacts of a palm are cancelled. Contact sizes are only read from the platform's own touches.
+        void                    enablePalmRejection( bool rejectPalms = true );
+        void                    disablePalmRejection() { enablePalmRejection( false ); }
+        bool                    isRejectingPalms() const { return mRejectingPalms; }
+        PalmRejector&           getPalmRejector() { return mPalmRejector; }
+        
+        //! Single entry point for touches from any source. Cancels stale touches, coalesces moves and calls touchesBegan() etc.
+        void                    dispatchTouches( TouchPhase phase, const ci::app::TouchEvent &event );
+        
+        //! Writes every dispatched touch event to the recorder, which should be open. Pass NULL to stop. Play back with TouchPlayer.
+        void                    setTouchRecorder( TouchRecorder *touchRecorder ) { mTouchRecorder = touchRecorder; }
+        TouchRecorder*          getTouchRecorder() const { return mTouchRecorder; }
     
      private:
         // for MouseEvent-to-TouchEvent translation. Great if you only have a mouse :)
@@ -59,10 +102,49 @@ namespace Pivot {
         bool            preTouchesEnded ( ci::app::TouchEvent event );
         
         void                                        cancelStaleTouches( const std::vector<ci::app::TouchEvent::Touch>& excludingTouches );
+        //! Compares the platform's active touches with the last ones seen, and remembers the new ones
+        std::vector<ci::app::TouchEvent::Touch>     findStaleTouches( const std::vector<ci::app::TouchEvent::Touch>& excludingTouches );
         std::vector<ci::app::TouchEvent::Touch>     getStaleTouches( const std::vector<ci::app::TouchEvent::Touch>& currentActiveTouches, 
                                                                      const std::vector<ci::app::TouchEvent::Touch>& newActiveTouches, 
                                                                      const std::vector<ci::app::TouchEvent::Touch>& excludingTouches );
         std::vector<ci::app::TouchEvent::Touch>     mCurrentActiveTouches;
+        
+        // for coalescing moves between frames
+        void                                        queueTouchesMoved( const std::vector<ci::app::TouchEvent::Touch>& touches );
+        void                                        flushTouches();
+        void                                        recordTouches( const std::vector<ci::app::TouchEvent::Touch>& touches );
+        void                                        forgetTouches( const std::vector<ci::app::TouchEvent::Touch>& touches );
+        bool                                        mCoalescingTouches;
+        std::vector<ci::app::TouchEvent::Touch>     mPendingMoves;
+        TouchHistory                                mTouchHistory;
+        
+        // for predicting touches to display time
+        struct PredictedTouch {
+            ci::app::TouchEvent::Touch  mTouch;
+            double                      mArrivalTime;
+            ci::Vec2f                   mDeliveredPos;
+        };
+        void                                        predictTouches();
+        bool                                        mPredictingTouches;
+        double                                      mPredictionLatency, mPredictionHorizon;
+        std::vector<PredictedTouch>                 mPredictedTouches;
+        
+        // for queueing touches until update
+        void                                        receiveTouches( TouchPhase phase, const std::vector<ci::app::TouchEvent::Touch>& touches );
+        void                                        preUpdate();
+        void                                        drainTouchInput( TouchInputQueue *input );
+        bool                                        mQueueingTouches, mDrainingTouches;
+        TouchInputQueue                             mTouchQueue;
+        std::vector<TouchInputQueue*>               mTouchInputs;
+        std::vector<ci::app::TouchEvent::Touch>     mDrainedTouches;
+        
+        // for rejecting palms before dispatch
+        void                                        deliverTouches( TouchPhase phase, const ci::app::TouchEvent &event );
+        void                                        cancelPalmTouches( const std::vector<ci::app::TouchEvent::Touch>& touches );
+        bool                                        mRejectingPalms;
+        PalmRejector                                mPalmRejector;
+        
+        TouchRecorder                               *mTouchRecorder;
     };
 
 }
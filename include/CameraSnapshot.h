@@ -0,0 +1,80 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Camera.h"
+#include "cinder/Matrix.h"
+#include "cinder/Ray.h"
+#include "cinder/Vector.h"
+
+namespace Pivot {
+	
+	//! Immutable copy of a CameraPersp and viewport, with the screen <-> world mappings precomputed.
+	//! Each snapshot gets a new version, so dependants can tell when the camera actually changed.
+	class CameraSnapshot {
+	  public:
+		CameraSnapshot();
+		CameraSnapshot( const ci::CameraPersp &cam, const ci::Vec2f &viewSize );
+		
+		//! Returns true if the snapshot was taken of an identical camera and viewport
+		bool			matches( const ci::CameraPersp &cam, const ci::Vec2f &viewSize ) const;
+		uint32_t		getVersion() const { return mVersion; }
+		
+		//! Returns the ray from the eye through a point on screen, measured in pixels
+		ci::Ray			generateRay( const ci::Vec2f &screenPos ) const
+		{
+			return ci::Ray( mEyePoint, ( mRayOrigin + mRayStepX * screenPos.x + mRayStepY * screenPos.y ).normalized() );
+		}
+		//! Returns the screen position of a point in world space, measured in pixels
+		ci::Vec2f		worldToScreen( const ci::Vec3f &worldPos ) const;
+		//! Returns the eye space depth of a point in world space. Negative in front of the camera.
+		float			worldToEyeDepth( const ci::Vec3f &worldPos ) const
+		{
+			return mEyeDepth.x * worldPos.x + mEyeDepth.y * worldPos.y + mEyeDepth.z * worldPos.z + mEyeDepthOffset;
+		}
+		
+		ci::Vec3f		getEyePoint() const { return mEyePoint; }
+		float			getFov() const { return mFov; }
+		float			getNearClip() const { return mNearClip; }
+		ci::Vec2f		getViewSize() const { return mViewSize; }
+		
+	  private:
+		ci::Matrix44f	mModelView, mProjection, mViewProjection;
+		ci::Vec2f		mViewSize, mHalfViewSize;
+		ci::Vec3f		mEyePoint;
+		float			mFov, mNearClip;
+		
+		// unnormalized ray direction at pixel (x,y) is mRayOrigin + mRayStepX * x + mRayStepY * y
+		ci::Vec3f		mRayOrigin, mRayStepX, mRayStepY;
+		ci::Vec3f		mEyeDepth;
+		float			mEyeDepthOffset;
+		
+		uint32_t		mVersion;
+	};
+	
+}
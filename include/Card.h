@@ -36,10 +36,11 @@ namespace Pivot {
 	
 	class Card : public TouchObject {
 	  public:
-		Card() {}
+		Card() : mAxesDirty( true ), mTransformVersion( 0 ) {}
 		Card( ci::Vec2f pos, float width, float height, float rotation, bool captureTouches = true );
 		
 		bool	hitTest( ci::app::TouchEvent::Touch touch );
+		bool	getBounds( ci::Rectf *bounds );
 		
 		void	pivotBegan( TouchPivot *touchPivot );
 		void	pivotMoved( TouchPivot *touchPivot );
@@ -47,22 +48,37 @@ namespace Pivot {
 		void	pivotEnded( TouchPivot *touchPivot );
 		void	pivotCancelled( TouchPivot *touchPivot );
 		
-		void	update( float deltaTime );
+		//! Pose getters blend the last two steps when a fixed timestep is enabled (see TouchObject::enableFixedTimestep())
+		void		setPos( ci::Vec2f pos ) { mPos = pos; transformChanged(); }
+		ci::Vec2f	getPos() { return isFixedTimestep() ? mPrevStepPos.lerp( mStepAlpha, mPos ) : mPos; }
 		
-		void		setPos( ci::Vec2f pos ) { mPos = pos; }
-		ci::Vec2f	getPos() { return mPos; }
+		void		setRot( float rotation ) { mRot = rotation; transformChanged(); }
+		float		getRot() { return isFixedTimestep() ? ci::lerp( mPrevStepRot, mRot, mStepAlpha ) : mRot; }
 		
-		void		setRot( float rotation ) { mRot = rotation; }
-		float		getRot() { return mRot; }
+		void		setScale( float scale ) { mScale = scale; transformChanged(); }
+		float		getScale() { return isFixedTimestep() ? ci::lerp( mPrevStepScale, mScale, mStepAlpha ) : mScale; }
 		
-		void		setScale( float scale ) { mScale = scale; }
-		float		getScale() { return mScale; }
+		void		setWidth( float width ) { mWidth = width; transformChanged(); }
+		float		getWidth() { return isFixedTimestep() ? ci::lerp( mPrevStepWidth, mWidth, mStepAlpha ) : mWidth; }
 		
-		void		setWidth( float width ) { mWidth = width; }
-		float		getWidth() { return mWidth; }
+		void		setHeight( float height ) { mHeight = height; transformChanged(); }
+		float		getHeight() { return isFixedTimestep() ? ci::lerp( mPrevStepHeight, mHeight, mStepAlpha ) : mHeight; }
 		
-		void		setHeight( float height ) { mHeight = height; }
-		float		getHeight() { return mHeight; }
+		//! Pose the current momentum reaches after time seconds, or where it comes to rest. O(1), without changing the card.
+		//! Touches still holding the card are assumed to stay put; range limits are applied as a clamp.
+		ci::Vec2f	getPosAt( float time );
+		float		getRotAt( float time );
+		float		getScaleAt( float time );
+		ci::Vec2f	getRestPos();
+		float		getRestRot();
+		float		getRestScale();
+		//! Returns the time until the current momentum comes to rest, in seconds. 0 if at rest.
+		float		getSettleTime();
+		
+		//! Returns the card's width and height edge vectors, rotated. Cached until the transform changes.
+		void		getAxes( ci::Vec2f *widthAxis, ci::Vec2f *heightAxis );
+		//! Incremented whenever position, rotation or size changes. Used by CardBatch to refresh only moved cards.
+		uint32_t	getTransformVersion() const { return mTransformVersion; }
 		
 		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
 		
@@ -88,6 +104,26 @@ namespace Pivot {
 		float		mScale, mScaleVel;
 		
 		float		mMinScale, mMaxScale, mPullResistance, mReleaseRetraction;
+		
+		ci::Vec2f	mPrevStepPos;
+		float		mPrevStepRot, mPrevStepScale, mPrevStepWidth, mPrevStepHeight;
+		
+		void		integrate( float deltaTime );
+		//! Applies range limits, puts the card to rest once motion is unnoticable and places it. Ends every momentum step.
+		void		endStep( float deltaTime );
+		void		storePrevPose();
+		void		calcCoastPose( float travel, ci::Vec2f *pos, float *rot, float *scale );
+		
+		//! Call whenever mPos, mRot, mWidth or mHeight change
+		void		transformChanged();
+		
+	  private:
+		friend class CardBatch;
+		friend class MomentumBatch;
+		
+		ci::Vec2f	mWidthAxis, mHeightAxis;
+		bool		mAxesDirty;
+		uint32_t	mTransformVersion;
 	};
 	
 }
@@ -0,0 +1,78 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include "cinder/Vector.h"
+#include <vector>
+
+#include "Card.h"
+
+namespace Pivot {
+	
+	//! Hit tests many touches against many Cards at once. Card axes are kept in structure-of-arrays form
+	//! and tested 8 (AVX) or 4 (SSE) cards at a time, with a scalar fallback elsewhere.
+	//! Cards in a TouchScene keep the scene's depth order, so both agree on which Card is in front.
+	class CardBatch {
+	  public:
+		CardBatch();
+		
+		//! Cards in a TouchScene are ordered as in the scene. Cards outside one go behind them, in the order they were added.
+		void	addCard( Card *card );
+		void	removeCard( Card *card );
+		void	clear();
+		
+		int		numCards() const { return mCards.size(); }
+		Card*	getCard( int index ) const { return mCards[index]; }
+		
+		//! Returns the index of the front-most Card containing pos, or -1. Cards should all be in the same TouchScene, or in none.
+		int		hitTest( const ci::Vec2f &pos );
+		//! Writes the index of the front-most Card containing each touch, or -1, into hits
+		void	hitTest( const std::vector<ci::app::TouchEvent::Touch> &touches, std::vector<int> *hits );
+		void	hitTest( const ci::Vec2f *points, int numPoints, int *hits );
+		
+	  protected:
+		//! Rewrites the axes of cards whose transform changed since the last hit test
+		void	refresh();
+		void	writeSlot( int index );
+		int		hitTestSlots( float x, float y ) const;
+		
+		std::vector<Card*>		mCards;
+		std::vector<uint32_t>	mVersions;
+		//! Read from the TouchScene on every refresh, since reordering doesn't touch the card
+		std::vector<int64_t>	mDepths;
+		bool					mLayoutDirty;
+		
+		// per-card origin, width/height axes and squared axis lengths, padded to a multiple of kLaneWidth
+		std::vector<float>		mPosX, mPosY, mWidthAxisX, mWidthAxisY, mHeightAxisX, mHeightAxisY, mWidthLenSq, mHeightLenSq;
+		int						mNumSlots;
+		
+		static const int		kLaneWidth = 8;
+	};
+	
+}
@@ -0,0 +1,118 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+#include <string>
+#include <vector>
+
+#include "TouchPointSet.h"
+
+namespace Pivot {
+	
+	//! Features describing the layout and motion of a set of touches, independent of their order, position and heading
+	enum ChordFeature {
+		CHORD_COUNT,			//!< number of touches
+		CHORD_SPREAD,			//!< mean distance from the centroid, measured in pixels
+		CHORD_RADIAL_VARIATION,	//!< deviation of the distances from the centroid, relative to the spread
+		CHORD_ANGULAR_GAP,		//!< widest empty angle around the centroid, as a fraction of a turn
+		CHORD_ELONGATION,		//!< 0 for touches spread evenly, up to 1 for touches in a line or two groups
+		CHORD_SPEED,			//!< speed of the centroid, measured in pixels per second
+		CHORD_RADIAL_SPEED,		//!< mean speed away from the centroid, measured in pixels per second. Negative for a grab.
+		CHORD_TANGENTIAL_SPEED,	//!< mean speed around the centroid, measured in pixels per second
+		CHORD_COHERENCE,		//!< 1 when every touch moves together, down to 0 when they cancel out
+		CHORD_NUM_FEATURES
+	};
+	
+	//! Result of ChordClassifier::classify()
+	struct Chord {
+		//! Index of the class, as returned by ChordClassifier::addExample(), or -1 if no example is near enough
+		int			mClass;
+		//! Share of the nearest examples voting for the class, weighted by closeness
+		float		mConfidence;
+		//! Distance to the nearest example of the class, in feature deviations
+		float		mDistance;
+		float		mFeatures[CHORD_NUM_FEATURES];
+	};
+	
+	
+	//! Tells chords and hand poses apart -- a three-finger swipe from a five-finger grab or a two-hand spread -- by comparing the
+	//! features of the active touches against labelled examples, k nearest neighbors at a time. Examples are kept back to back
+	//! in one flat array, with each feature scaled by its deviation over the examples. Classifying never allocates.
+	class ChordClassifier {
+	  public:
+		static const int kMaxTouches = 10;
+		static const int kMaxNeighbors = 8;
+		
+		ChordClassifier();
+		
+		//! Writes the features of up to kMaxTouches touches
+		static void			calcFeatures( const TouchPointSpan &touchPoints, float *features );
+		
+		//! Adds an example to the named class, creating it if needed. Returns the class index.
+		int					addExample( const std::string &className, const float *features );
+		int					addExample( const std::string &className, const TouchPointSpan &touchPoints );
+		const std::string&	getClassName( int index ) const { return mClassNames[index]; }
+		int					numClasses() const { return mClassNames.size(); }
+		int					numExamples() const { return mLabels.size(); }
+		bool				empty() const { return mLabels.empty(); }
+		void				clear();
+		
+		//! Classifies the features. Returns false, with mClass -1, if no example is within the max distance.
+		bool				classify( const float *features, Chord *chord );
+		bool				classify( const TouchPointSpan &touchPoints, Chord *chord );
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Number of nearest examples voting, up to kMaxNeighbors
+		void				setNumNeighbors( int numNeighbors );
+		int					getNumNeighbors() const { return mNumNeighbors; }
+		//! Farthest an example may be and still be recognized, in feature deviations
+		void				setMaxDistance( float distance ) { mMaxDistance = distance; }
+		float				getMaxDistance() const { return mMaxDistance; }
+		//! Scales a feature's say in the distance. 0 ignores it.
+		void				setFeatureWeight( ChordFeature feature, float weight ) { mWeights[feature] = weight; mIsScaleDirty = true; }
+		float				getFeatureWeight( ChordFeature feature ) const { return mWeights[feature]; }
+		
+	  private:
+		//! Rescales the examples after they or the weights change
+		void				updateScales();
+		
+		std::vector<std::string>	mClassNames;
+		// CHORD_NUM_FEATURES raw and scaled floats per example, and its class
+		std::vector<float>			mExamples, mScaledExamples;
+		std::vector<int>			mLabels;
+		
+		float				mWeights[CHORD_NUM_FEATURES], mScales[CHORD_NUM_FEATURES];
+		bool				mIsScaleDirty;
+		
+		int					mNumNeighbors;
+		float				mMaxDistance;
+	};
+	
+}
@@ -0,0 +1,90 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "GestureRecognizer.h"
+
+namespace Pivot {
+	
+	//! Runs a set of GestureRecognizers on one object's touches and settles their conflicts. A tap or swipe waits for every earlier
+	//! recognizer to fail, so add double taps before single taps. A long press or press-drag wins by beginning first. Whichever
+	//! gesture is reported fails the rest. Costs O(1) per event for a given set of recognizers, and only allocates once set up if
+	//! more than kPendingGesturesReserve gestures pile up between popGesture() calls.
+	class GestureEngine {
+	  public:
+		//! Pending gestures there's room for up front. More than that between popGesture() calls grows the queue, never drops one.
+		static const int kPendingGesturesReserve = 8;
+		//! Seconds engine time may step back by before it's taken as a new time base rather than latency
+		static const double kTimeBaseJump;
+		
+		GestureEngine();
+		
+		//! Returns the index reported in each Gesture::mRecognizer
+		int					addRecognizer( const GestureRecognizer &recognizer );
+		GestureRecognizer&	getRecognizer( int index ) { return mRecognizers[index]; }
+		int					numRecognizers() const { return mRecognizers.size(); }
+		bool				empty() const { return mRecognizers.empty(); }
+		void				clear();
+		
+		//! Each takes the number of touches down after the event, and the centroid of all touches involved. Times come from the
+		//! object's TouchClock, and the engine's time only steps back to a new time base.
+		void				touchesBegan( int numTouches, const ci::Vec2f &centroid, double time );
+		void				touchesMoved( int numTouches, const ci::Vec2f &centroid, double time );
+		void				touchesEnded( int numTouches, const ci::Vec2f &centroid, double time );
+		//! Cancels active gestures and fails the rest, until every touch is up
+		void				touchesCancelled( int numTouches, double time );
+		//! Advances time between events to \a time, read from the same TouchClock (see TouchClock::getCurrentTime()), for timeouts and long presses
+		void				update( double time );
+		
+		//! Pops the oldest reported gesture. Returns false once there are none.
+		bool				popGesture( Gesture *gesture );
+		
+	  private:
+		void				handle( int index, bool reported, const Gesture &gesture );
+		void				resolve();
+		void				failOthers( int index );
+		void				push( int index, const Gesture &gesture );
+		//! Moves mTime forward to \a time, never back except to a new time base, and returns the new mTime
+		double				advance( double time );
+		
+		std::vector<GestureRecognizer>	mRecognizers;
+		std::vector<Gesture>			mWaitingGestures;
+		
+		std::vector<Gesture>	mPending;
+		int					mPendingHead;
+		
+		// the centroid jumps when touches come and go, so recognizers see one that only follows movement
+		int					mNumTouches;
+		ci::Vec2f			mPos, mCentroid;
+		bool				mHasCentroid;
+		double				mTime;
+	};
+	
+}
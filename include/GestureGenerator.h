@@ -0,0 +1,113 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include "cinder/Rand.h"
+#include "cinder/Rect.h"
+#include "cinder/Vector.h"
+#include <functional>
+#include <vector>
+
+#include "TouchPoint.h"
+
+namespace Pivot {
+	
+	//! Produces synthetic touch streams for load and regression testing. Output depends only on the seed and
+	//! the calls made, never on wall time: timestamps advance by 1/rate per sample from the start time.
+	class GestureGenerator {
+	  public:
+		typedef std::function<void ( TouchPhase, const ci::app::TouchEvent& )>	Target;
+		
+		GestureGenerator( uint32_t seed = 0 );
+		
+		void		setTarget( const Target &target ) { mTarget = target; }
+		void		seed( uint32_t seed ) { mRand.seed( seed ); }
+		
+		//! Area that random gestures are placed in, measured in pixels
+		void		setBounds( const ci::Rectf &bounds ) { mBounds = bounds; }
+		ci::Rectf	getBounds() const { return mBounds; }
+		//! Samples per second for every touch, like a digitizer's report rate
+		void		setRate( float rate ) { mRate = rate; }
+		float		getRate() const { return mRate; }
+		//! Random offset added to every sample, measured in pixels
+		void		setJitter( float jitter ) { mJitter = jitter; }
+		float		getJitter() const { return mJitter; }
+		//! Timestamp of the next sample, measured in seconds. Each gesture advances it.
+		void		setTime( double time ) { mTime = time; }
+		double		getTime() const { return mTime; }
+		
+		// Each gesture plays to completion before returning. Durations are measured in seconds.
+		
+		//! numFingers touches moving together by offset
+		void	drag( int numFingers, const ci::Vec2f &center, const ci::Vec2f &offset, float duration );
+		//! numFingers touches on a circle around center, spreading from one radius to another. Fingers spread by scaling their
+		//! offsets, so a fromRadius under a pixel starts them one pixel out.
+		void	pinch( int numFingers, const ci::Vec2f &center, float fromRadius, float toRadius, float duration );
+		//! numFingers touches on a circle around center, turning by angle radians
+		void	rotate( int numFingers, const ci::Vec2f &center, float radius, float angle, float duration );
+		//! A single touch released while still moving at velocity, measured in pixels per second
+		void	flick( const ci::Vec2f &pos, const ci::Vec2f &velocity, float duration );
+		//! numUsers people each doing random drags, pinches and rotations at once, in their own part of the bounds
+		void	chaos( int numUsers, float duration );
+		//! numTouches short taps with random positions and overlapping lifetimes
+		void	storm( int numTouches, float duration );
+		//! One of the above with random parameters inside the bounds
+		void	randomGesture();
+		
+	  private:
+		//! A touch following a straight, scaling, turning path around a center
+		struct Finger {
+			uint32_t	mId;
+			double		mBeginTime, mEndTime;
+			ci::Vec2f	mCenter, mOffset, mTranslation;
+			float		mScale, mAngle;
+			ci::Vec2f	mPrevPos;
+			bool		mIsBegun;
+		};
+		
+		void		addFinger( double beginTime, double endTime, const ci::Vec2f &center, const ci::Vec2f &offset, const ci::Vec2f &translation, float scale, float angle );
+		void		addCircle( double beginTime, double endTime, int numFingers, const ci::Vec2f &center, float radius, const ci::Vec2f &translation, float scale, float angle );
+		void		addRandomGesture( double beginTime, const ci::Rectf &bounds, float maxDuration );
+		//! Plays every added finger to its end, then forgets them
+		void		play();
+		ci::Vec2f	calcPos( const Finger &finger, double time );
+		void		emit( TouchPhase phase );
+		
+		ci::Rand					mRand;
+		ci::Rectf					mBounds;
+		float						mRate, mJitter;
+		double						mTime;
+		uint32_t					mNextId;
+		Target						mTarget;
+		
+		std::vector<Finger>						mFingers;
+		std::vector<ci::app::TouchEvent::Touch>	mTouches;
+	};
+	
+}
@@ -0,0 +1,125 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+
+namespace Pivot {
+	
+	enum GestureType { GESTURE_TAP, GESTURE_LONG_PRESS, GESTURE_SWIPE, GESTURE_PRESS_DRAG };
+	enum GesturePhase { GESTURE_BEGAN, GESTURE_CHANGED, GESTURE_ENDED, GESTURE_CANCELLED };
+	
+	//! A recognized gesture. Taps and swipes arrive once, as GESTURE_ENDED. Long presses and press-drags begin, change and end.
+	struct Gesture {
+		//! Index of the recognizer, as returned by TouchObject::addGestureRecognizer()
+		int				mRecognizer;
+		GestureType		mType;
+		GesturePhase	mPhase;
+		int				mNumTouches, mNumTaps;
+		//! Centroid of the touches now and when the gesture started, measured in pixels
+		ci::Vec2f		mPos, mStartPos;
+		//! Swipe velocity measured in pixels per second. Zero for other gestures.
+		ci::Vec2f		mVelocity;
+		double			mTime;
+	};
+	
+	
+	//! Finite-state machine for one discrete gesture, fed with the touch count and centroid of an object's touches.
+	//! Stored inline, so running it never allocates. Usually run by a GestureEngine, which settles conflicts between recognizers.
+	class GestureRecognizer {
+	  public:
+		enum State { POSSIBLE, WAITING, ACTIVE, RECOGNIZED, FAILED };
+		
+		GestureRecognizer( GestureType type = GESTURE_TAP, int numTouches = 1 );
+		
+		GestureType		getType() const { return mType; }
+		int				getNumTouches() const { return mNumTouches; }
+		State			getState() const { return mState; }
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Taps in a row needed for GESTURE_TAP
+		void			setNumTaps( int numTaps ) { mNumTaps = numTaps; }
+		int				getNumTaps() const { return mNumTaps; }
+		//! Distance touches may wander before a tap or press fails, measured in pixels
+		void			setMaxMovement( float distance ) { mMaxMovement = distance; }
+		float			getMaxMovement() const { return mMaxMovement; }
+		//! Longest a tap may stay down, measured in seconds
+		void			setMaxTapDuration( float seconds ) { mMaxTapDuration = seconds; }
+		float			getMaxTapDuration() const { return mMaxTapDuration; }
+		//! Longest pause between taps, measured in seconds
+		void			setMaxTapInterval( float seconds ) { mMaxTapInterval = seconds; }
+		float			getMaxTapInterval() const { return mMaxTapInterval; }
+		//! Farthest a later tap may land from the first, measured in pixels
+		void			setMaxTapDistance( float distance ) { mMaxTapDistance = distance; }
+		float			getMaxTapDistance() const { return mMaxTapDistance; }
+		//! How long touches hold still before a long press begins or a press-drag may drag, measured in seconds
+		void			setPressDuration( float seconds ) { mPressDuration = seconds; }
+		float			getPressDuration() const { return mPressDuration; }
+		//! Shortest swipe, measured in pixels
+		void			setMinSwipeDistance( float distance ) { mMinSwipeDistance = distance; }
+		float			getMinSwipeDistance() const { return mMinSwipeDistance; }
+		//! Slowest swipe, measured in pixels per second
+		void			setMinSwipeVelocity( float velocity ) { mMinSwipeVelocity = velocity; }
+		float			getMinSwipeVelocity() const { return mMinSwipeVelocity; }
+		//! Longest swipe, measured in seconds
+		void			setMaxSwipeDuration( float seconds ) { mMaxSwipeDuration = seconds; }
+		float			getMaxSwipeDuration() const { return mMaxSwipeDuration; }
+		
+		// STATE MACHINE //////////////////////////////////////////////////////
+		
+		//! Starts over, ready for the next touches
+		void			reset();
+		
+		//! Each takes the number of touches down after the event and their centroid, and returns true with a gesture to report
+		bool			touchesBegan( int numTouches, const ci::Vec2f &pos, double time, Gesture *gesture );
+		bool			touchesMoved( int numTouches, const ci::Vec2f &pos, double time, Gesture *gesture );
+		bool			touchesEnded( int numTouches, const ci::Vec2f &pos, double time, Gesture *gesture );
+		//! Applies timeouts, and begins long presses. Call between events.
+		bool			update( double time, Gesture *gesture );
+		
+	  private:
+		bool			report( GesturePhase phase, const ci::Vec2f &pos, double time, Gesture *gesture );
+		bool			fail() { mState = FAILED; return false; }
+		bool			isMoved( const ci::Vec2f &pos ) const { return pos.distanceSquared( mDownPos ) > mMaxMovement * mMaxMovement; }
+		
+		GestureType		mType;
+		int				mNumTouches, mNumTaps;
+		float			mMaxMovement, mMaxTapDuration, mMaxTapInterval, mMaxTapDistance, mPressDuration;
+		float			mMinSwipeDistance, mMinSwipeVelocity, mMaxSwipeDuration;
+		
+		State			mState;
+		int				mNumDown, mMaxDown, mTapCount;
+		bool			mIsPressed;
+		ci::Vec2f		mStartPos, mDownPos;
+		double			mDownTime, mUpTime;
+		
+		friend class GestureEngine;
+	};
+	
+}
@@ -0,0 +1,149 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+#include <string>
+#include <vector>
+
+#include "TouchPointSet.h"
+
+namespace Pivot {
+	
+	//! A template spotted within a touch's path by GestureSpotter
+	struct SpottedGesture {
+		//! Index of the template, as returned by GestureSpotter::addTemplate()
+		int			mTemplate;
+		std::string	mName;
+		uint32_t	mTouchId;
+		//! 1 for a perfect fit, falling to 0 at the template's max cost
+		float		mConfidence;
+		//! Summed direction mismatch along the warping path
+		float		mCost;
+		//! Where and when the matching part of the path started and ended, measured in pixels and seconds
+		ci::Vec2f	mStartPos, mEndPos;
+		double		mStartTime, mEndTime;
+	};
+	
+	
+	//! Spots templates anywhere within each touch's path as it is drawn, with no need to start or end cleanly. Paths are resampled
+	//! into steps of equal length, and each step's direction is matched to the templates by subsequence dynamic time warping
+	//! (SPRING), which reports the best match once no overlapping one can beat it. Warping costs only grow, so cells past a
+	//! template's max cost are abandoned and each step only visits the live band of each template, or a single cell while idle.
+	//! Work per step is bounded by the total template length, and nothing is allocated once every touch has been seen.
+	class GestureSpotter {
+	  public:
+		static const int kMaxTemplateLength = 64;
+		static const int kMaxStepsPerEvent = 16;
+		
+		GestureSpotter();
+		
+		//! Adds a template path, drawn at the size it's expected. Returns the index reported in SpottedGesture::mTemplate,
+		//! or -1 if the path is shorter than two steps. Paths longer than kMaxTemplateLength steps are truncated.
+		int					addTemplate( const std::string &name, const std::vector<ci::Vec2f> &points );
+		const std::string&	getTemplateName( int index ) const { return mTemplates[index].mName; }
+		int					numTemplates() const { return mTemplates.size(); }
+		bool				empty() const { return mTemplates.empty(); }
+		void				clear();
+		
+		void				touchesBegan( const TouchPointSpan &touchPoints );
+		void				touchesMoved( const TouchPointSpan &touchPoints );
+		//! Reports any match still waiting on the touch's path
+		void				touchesEnded( const TouchPointSpan &touchPoints );
+		void				touchesCancelled( const TouchPointSpan &touchPoints );
+		
+		//! Pops the oldest spotted gesture. Returns false once there are none.
+		bool				popGesture( SpottedGesture *gesture );
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Length of each resampled step, measured in pixels. Applies to templates added afterwards.
+		void				setStepLength( float length ) { mStepLength = length; }
+		float				getStepLength() const { return mStepLength; }
+		//! Largest mean mismatch per template step spotted, from 0 for the same direction to 2 for the opposite one
+		void				setMaxCost( float cost ) { mMaxCost = cost; }
+		float				getMaxCost() const { return mMaxCost; }
+		//! Extra cost of matching one step to several, which lets a path be drawn faster or slower in places than its template
+		void				setWarpPenalty( float cost ) { mWarpPenalty = cost; }
+		float				getWarpPenalty() const { return mWarpPenalty; }
+		
+	  private:
+		static const int	kHistorySize = 256;
+		
+		struct Template {
+			std::string		mName;
+			int				mOffset, mLength;
+		};
+		
+		//! Accumulated cost of the best warping path ending at a template step, and the stream step it started at
+		struct Cell {
+			float		mCost;
+			uint32_t	mStart;
+		};
+		
+		//! SPRING's state for one template on one stream: its live band of cells, and the best match not yet reported
+		struct Match {
+			int			mLo, mHi;
+			float		mBestCost;
+			uint32_t	mBestStart, mBestEnd;
+		};
+		
+		struct Stream {
+			uint32_t				mId;
+			bool					mIsActive;
+			ci::Vec2f				mAnchor;
+			uint32_t				mNumSteps;
+			std::vector<Cell>		mCells;
+			std::vector<Match>		mMatches;
+			// positions and times of the latest steps, to report where matches started
+			ci::Vec2f				mHistoryPos[kHistorySize];
+			double					mHistoryTime[kHistorySize];
+		};
+		
+		Stream*				findStream( uint32_t id );
+		void				beginStream( Stream *stream, const ci::Vec2f &pos, double time );
+		//! Resamples the path on to pos, stepping every template at most kMaxStepsPerEvent times
+		void				moveStream( Stream *stream, const ci::Vec2f &pos, double time );
+		void				step( Stream *stream, const ci::Vec2f &dir, const ci::Vec2f &pos, double time );
+		//! Reports template t's best match on the stream, then abandons every path overlapping it
+		void				report( Stream *stream, int t );
+		void				resetStream( Stream *stream );
+		int					findHistory( const Stream &stream, uint32_t step ) const;
+		
+		std::vector<Template>	mTemplates;
+		// unit direction of every template step, templates back to back
+		std::vector<float>		mDirX, mDirY;
+		std::vector<Stream>		mStreams;
+		
+		std::vector<SpottedGesture>	mPending;
+		size_t					mPendingHead;
+		
+		float					mStepLength, mMaxCost, mWarpPenalty;
+	};
+	
+}
@@ -0,0 +1,59 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+namespace Pivot {
+	
+	//! Exponentially decaying momentum: velocity v0 * e^(-kt), covering v0 * ( 1 - e^(-kt) ) / k.
+	//! Exact for any time step, so a release plays out the same at every frame rate and can be evaluated at any time in O(1).
+	class InertiaCurve {
+	  public:
+		InertiaCurve() : mDecayRate( 1.0f ) {}
+		explicit InertiaCurve( float decayRate ) { setDecayRate( decayRate ); }
+		
+		//! Returns the curve matching a TouchObject velocity decay factor, which was applied once per frame at 60 fps
+		static InertiaCurve	fromVelDecay( float velDecay );
+		
+		//! Decay rate k, per second
+		void	setDecayRate( float decayRate );
+		float	getDecayRate() const { return mDecayRate; }
+		
+		//! Returns the fraction of the initial velocity left after time
+		float	getVelocityFactor( float time ) const;
+		//! Returns the distance covered after time, per unit of initial velocity
+		float	getDistanceFactor( float time ) const;
+		//! Returns the distance covered before coming to rest, per unit of initial velocity
+		float	getRestFactor() const { return 1.0f / mDecayRate; }
+		//! Returns the time for speed to decay below threshold, or 0 if it already is
+		float	getSettleTime( float speed, float threshold ) const;
+		
+	  private:
+		float	mDecayRate;
+	};
+	
+}
@@ -0,0 +1,65 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace Pivot {
+	
+	//! Owns a T allocated on first use, so objects that never use it don't carry its size. Copies deep-copy it.
+	template<class T>
+	class LazyMember {
+	  public:
+		LazyMember() : mPtr( NULL ) {}
+		LazyMember( const LazyMember &other ) : mPtr( other.mPtr ? new T( *other.mPtr ) : NULL ) {}
+		~LazyMember() { delete mPtr; }
+		LazyMember& operator=( const LazyMember &other )
+		{
+			if ( this != &other ) {
+				T *ptr = other.mPtr ? new T( *other.mPtr ) : NULL;
+				delete mPtr;
+				mPtr = ptr;
+			}
+			return *this;
+		}
+		
+		//! Returns the T, allocating it if needed
+		T&		get() { if ( ! mPtr ) mPtr = new T(); return *mPtr; }
+		//! Frees the T
+		void	reset() { delete mPtr; mPtr = NULL; }
+		//! Returns true if there's no T or it has nothing loaded
+		bool	empty() const { return ! mPtr || mPtr->empty(); }
+		bool	isAllocated() const { return mPtr != NULL; }
+		T*		operator->() const { return mPtr; }
+		T&		operator*() const { return *mPtr; }
+		
+	  private:
+		T		*mPtr;
+	};
+	
+}
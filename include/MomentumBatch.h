@@ -0,0 +1,95 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "Card.h"
+#include "Trackball.h"
+#include "Trackball3D.h"
+
+namespace Pivot {
+	
+	//! Integrates the momentum of many Cards and Trackballs at once. Each object in motion owns a lane in structure-of-arrays
+	//! form that keeps its velocities between updates; lanes are stepped 4 at a time (SSE), with a scalar fallback elsewhere,
+	//! and only the resulting poses are written back. Objects at rest are not visited at all; a touch release that sets one in
+	//! motion wakes it. Member objects' own update() does nothing, so they may stay in a TouchScene. Members don't use fixed
+	//! timesteps: adding an object disables its own, and enableFixedTimestep() does nothing while it's in a batch.
+	class MomentumBatch {
+	  public:
+		MomentumBatch();
+		~MomentumBatch();
+		
+		void	addObject( Card *card );
+		void	addObject( Trackball *trackball );
+		void	addObject( Trackball3D *trackball );
+		void	removeObject( TouchObject *object );
+		void	clear();
+		
+		//! Steps every object in motion, then puts the ones that came to rest to sleep
+		void	update( float deltaTime = 0.01667f );
+		
+		int		numObjects() const { return mObjects.size(); }
+		//! Returns the number of objects currently in motion
+		int		numActive() const { return mActive.size(); }
+		
+	  protected:
+		enum Kind { CARD, TRACKBALL, TRACKBALL_3D };
+		
+		friend class TouchObject;
+		void	addObject( TouchObject *object, Kind kind );
+		//! Called by TouchObject after touch or decay changes. Reloads the object's lane from it, adding one if it's now in motion.
+		void	wake( TouchObject *object );
+		//! Called by TouchObject before its velocities are read or changed. Copies them back from the object's lane, if it's current.
+		void	storeVelocities( TouchObject *object );
+		
+		//! Loads a lane's velocities and inertia factors from its object
+		void	gather( int lane, TouchObject *object );
+		void	integrateLanes();
+		//! Writes a lane's step back to its object's pose and ends its step, clearing isInMotion() once it comes to rest
+		void	scatter( int lane, TouchObject *object, float deltaTime );
+		void	writeVelocities( int lane, TouchObject *object );
+		//! Recomputes a lane's travel and velocity factors for mDeltaTime
+		void	updateFactors( int lane );
+		void	removeLane( int lane );
+		void	resizeLanes();
+		
+		//! Active objects, in lane order
+		std::vector<TouchObject*>	mObjects, mActive;
+		
+		// per-lane velocities and decay rates, padded to a multiple of kLaneWidth; padding lanes are never scattered. Travel and
+		// velocity factor come from the lane's decay rate over mDeltaTime, and steps are the pose change of the last update.
+		std::vector<float>			mVelX, mVelY, mVelZ, mRotVel, mScaleVel, mDecayRate, mTravel, mVelFactor;
+		std::vector<float>			mStepX, mStepY, mStepZ, mStepRot, mStepScale;
+		int							mNumLanes;
+		float						mDeltaTime;
+		
+		static const int			kLaneWidth = 4;
+	};
+
+}
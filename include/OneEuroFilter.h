@@ -0,0 +1,101 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/CinderMath.h"
+#include "cinder/Quaternion.h"
+#include "cinder/Vector.h"
+
+namespace Pivot {
+	
+	//! Adaptive low-pass filter (Casiez, Roussel and Vogel's "1 Euro Filter"). Smooths hard while the value holds still and
+	//! follows closely while it moves fast. Driven by timestamps, so its feel doesn't depend on the frame or event rate.
+	//! T may be float, ci::Vec2f or ci::Quatf.
+	template<typename T>
+	class OneEuroFilter {
+	  public:
+		//! \a minCutoff is the cutoff frequency at rest, in Hz. Lower smooths more. \a beta raises it per unit of speed, cutting lag while moving.
+		OneEuroFilter( float minCutoff = 1.0f, float beta = 0.0f, float derivativeCutoff = 1.0f )
+		: mMinCutoff( minCutoff ), mBeta( beta ), mDerivativeCutoff( derivativeCutoff ), mSpeed( 0.0f ), mTime( 0.0 ), mHasValue( false ) {}
+		
+		void		setMinCutoff( float minCutoff ) { mMinCutoff = minCutoff; }
+		float		getMinCutoff() const { return mMinCutoff; }
+		void		setBeta( float beta ) { mBeta = beta; }
+		float		getBeta() const { return mBeta; }
+		//! Cutoff frequency for the speed estimate that drives the adaptation, in Hz
+		void		setDerivativeCutoff( float derivativeCutoff ) { mDerivativeCutoff = derivativeCutoff; }
+		float		getDerivativeCutoff() const { return mDerivativeCutoff; }
+		
+		//! Forgets the filtered value, so the next one passes through unchanged. Call wherever the input jumps on purpose.
+		void		reset() { mHasValue = false; mSpeed = 0.0f; }
+		bool		hasValue() const { return mHasValue; }
+		
+		//! Filters a value sampled at time, in seconds. Samples at or before the last one's time only replace the value if it is unset.
+		const T&	filter( const T &value, double time )
+		{
+			if ( ! mHasValue ) {
+				mValue = value;
+				mTime = time;
+				mHasValue = true;
+				return mValue;
+			}
+			
+			double deltaTime = time - mTime;
+			if ( deltaTime <= 0.0 ) return mValue;
+			mTime = time;
+			
+			mSpeed += ( calcDistance( mValue, value ) / float( deltaTime ) - mSpeed ) * calcAlpha( mDerivativeCutoff, deltaTime );
+			mValue = blend( mValue, value, calcAlpha( mMinCutoff + mBeta * mSpeed, deltaTime ) );
+			return mValue;
+		}
+		
+		const T&	getValue() const { return mValue; }
+		
+	  private:
+		static float	calcAlpha( float cutoff, double deltaTime )
+		{
+			double tau = 1.0 / ( 2.0 * M_PI * ci::math<float>::max( cutoff, 0.0001f ) );
+			return float( 1.0 / ( 1.0 + tau / deltaTime ) );
+		}
+		
+		static float		calcDistance( float a, float b ) { return ci::math<float>::abs( b - a ); }
+		static float		calcDistance( const ci::Vec2f &a, const ci::Vec2f &b ) { return a.distance( b ); }
+		static float		calcDistance( const ci::Quatf &a, const ci::Quatf &b ) { return 2.0f * ci::math<float>::acos( ci::math<float>::min( ci::math<float>::abs( a.dot( b ) ), 1.0f ) ); }
+		
+		static float		blend( float a, float b, float alpha ) { return a + ( b - a ) * alpha; }
+		static ci::Vec2f	blend( const ci::Vec2f &a, const ci::Vec2f &b, float alpha ) { return a.lerp( alpha, b ); }
+		static ci::Quatf	blend( const ci::Quatf &a, const ci::Quatf &b, float alpha ) { return a.slerp( alpha, b ); }
+		
+		float	mMinCutoff, mBeta, mDerivativeCutoff;
+		T		mValue;
+		float	mSpeed;
+		double	mTime;
+		bool	mHasValue;
+	};
+	
+}
@@ -0,0 +1,108 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include <boost/unordered_set.hpp>
+#include <functional>
+#include <vector>
+
+namespace Pivot {
+	
+	//! Rejects palms, sleeves and forearms as their contacts land, so they never reach a hit test. A contact is rejected if
+	//! - the platform reports it larger than a fingertip (see readContactSizes)
+	//! - it lands in a burst denser than fingers can make
+	//! - it lands near a contact rejected shortly before, as a palm or arm settles
+	//! Recent contacts that turn out to belong to a burst after being accepted are handed back for cancelling.
+	class PalmRejector {
+	  public:
+		//! Returns true and the contact's width and height in pixels, if the touch carries them
+		typedef std::function<bool ( const ci::app::TouchEvent::Touch&, ci::Vec2f* )>	ContactSizeFn;
+		
+		PalmRejector();
+		
+		//! Remembers the contact sizes of touches about to begin. Call as they arrive from the platform, while getNative() is
+		//! still valid. Reads TOUCHINPUT contact areas on Windows, or whatever the ContactSizeFn reports.
+		void	readContactSizes( const std::vector<ci::app::TouchEvent::Touch> &touches );
+		
+		//! Removes rejected touches. Touches accepted earlier that now turn out to be part of a palm are added to cancelledTouches.
+		void	touchesBegan( std::vector<ci::app::TouchEvent::Touch> *touches, std::vector<ci::app::TouchEvent::Touch> *cancelledTouches );
+		//! Removes touches rejected when they began
+		void	touchesMoved( std::vector<ci::app::TouchEvent::Touch> *touches );
+		//! Removes touches rejected when they began, and forgets them. Also used for cancelled touches.
+		void	touchesEnded( std::vector<ci::app::TouchEvent::Touch> *touches );
+		void	clear();
+		
+		bool	isRejected( uint32_t touchId ) const { return mRejectedIds.find( touchId ) != mRejectedIds.end(); }
+		//! Returns the number of rejected touches still down
+		int		numRejected() const { return mRejectedIds.size(); }
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Reads contact sizes from the touches instead of the platform default. Pass NULL to restore it.
+		void	setContactSizeFn( const ContactSizeFn &contactSizeFn ) { mContactSizeFn = contactSizeFn; }
+		//! Largest contact accepted as a finger, measured in pixels along its longer side
+		void	setMaxContactSize( float size ) { mMaxContactSize = size; }
+		float	getMaxContactSize() const { return mMaxContactSize; }
+		//! Most contacts allowed to land within the burst radius and burst time of a new contact, counting it. One more makes a palm.
+		void	setMaxBurstSize( int numContacts ) { mMaxBurstSize = numContacts; }
+		int		getMaxBurstSize() const { return mMaxBurstSize; }
+		//! Measured in pixels
+		void	setBurstRadius( float radius ) { mBurstRadius = radius; }
+		float	getBurstRadius() const { return mBurstRadius; }
+		//! Measured in seconds
+		void	setBurstTime( float seconds ) { mBurstTime = seconds; }
+		float	getBurstTime() const { return mBurstTime; }
+		//! Contacts landing this close to a rejected one, measured in pixels, are rejected along with it
+		void	setSettleRadius( float radius ) { mSettleRadius = radius; }
+		float	getSettleRadius() const { return mSettleRadius; }
+		//! For this long after it landed, measured in seconds
+		void	setSettleTime( float seconds ) { mSettleTime = seconds; }
+		float	getSettleTime() const { return mSettleTime; }
+		
+	  private:
+		//! A contact that landed within the burst or settle time
+		struct Contact {
+			ci::app::TouchEvent::Touch	mTouch;
+			bool						mIsRejected, mIsDelivered, mIsEnded;
+		};
+		
+		//! Rejects the contact, and the recent contacts around it if they make a burst
+		void	classify( int index );
+		bool	readContactSize( const ci::app::TouchEvent::Touch &touch, ci::Vec2f *size ) const;
+		
+		std::vector<Contact>									mContacts;
+		boost::unordered_set<uint32_t>							mRejectedIds;
+		std::vector< std::pair<uint32_t, ci::Vec2f> >			mContactSizes;
+		ContactSizeFn											mContactSizeFn;
+		
+		float		mMaxContactSize, mBurstRadius, mBurstTime, mSettleRadius, mSettleTime;
+		int			mMaxBurstSize;
+	};
+	
+}
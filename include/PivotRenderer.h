@@ -28,6 +28,7 @@
 #pragma once
 
 #include "cinder/gl/gl.h"
+#include <memory>
 
 #include "Trackball3D.h"
 #include "Trackball.h"
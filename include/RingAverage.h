@@ -0,0 +1,74 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/CinderMath.h"
+
+namespace Pivot {
+	
+	//! Moving average over the last getLength() values, up to Capacity. Stored inline with a running sum, so pushing
+	//! and averaging are O(1), and copying never allocates. T needs +, -, and division by float.
+	template<typename T, int Capacity>
+	class RingAverage {
+	  public:
+		RingAverage() : mLength( Capacity ) { clear(); }
+		
+		//! Sets how many recent values are averaged, clamped to [1, Capacity]. Clears the ring.
+		void	setLength( int length ) { mLength = ci::math<int>::clamp( length, 1, Capacity ); clear(); }
+		int		getLength() const { return mLength; }
+		
+		void	push_back( const T &value )
+		{
+			if ( mSize == mLength ) mSum = mSum - mValues[mHead];
+			else ++mSize;
+			mValues[mHead] = value;
+			mSum = mSum + value;
+			
+			// resum once per lap, so rounding in the running sum can't build up
+			if ( ++mHead == mLength ) {
+				mHead = 0;
+				mSum = mValues[0];
+				for( int i = 1; i < mSize; ++i ) mSum = mSum + mValues[i];
+			}
+		}
+		
+		void	clear() { mHead = mSize = 0; mSum = T(); }
+		bool	empty() const { return mSize == 0; }
+		int		size() const { return mSize; }
+		
+		//! Returns the average of the values held. Check empty() first.
+		T		getAverage() const { return mSum / float( mSize ); }
+		T		getSum() const { return mSum; }
+		
+	  private:
+		T		mValues[Capacity];
+		T		mSum;
+		int		mLength, mHead, mSize;
+	};
+	
+}
@@ -0,0 +1,141 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TouchPointSet.h"
+
+namespace Pivot {
+	
+	//! Result of StrokeRecognizer::recognize()
+	struct StrokeMatch {
+		StrokeMatch() : mTemplate( -1 ), mDistance( 0.0f ), mNumStrokes( 0 ), mSize( 0.0f ) {}
+		
+		int			mTemplate;
+		std::string	mName;
+		//! Weighted mean distance between matched points, in units of the shapes' larger extent. 0 is a perfect fit.
+		float		mDistance;
+		int			mNumStrokes;
+		//! Centroid and larger extent of the drawn strokes, measured in pixels
+		ci::Vec2f	mCenter;
+		float		mSize;
+	};
+	
+	
+	//! Point-cloud ($P/$Q) recognizer for drawn shapes and symbols, with one or more strokes in any order or direction.
+	//! Templates are resampled to kNumPoints, scaled and centered once when added, and kept in structure-of-arrays form
+	//! with a coarse distance field each. The fields give every template a cheap lower bound, so templates are matched
+	//! best bound first and the rest abandoned as soon as they can't win. Point searches run 4 at a time (SSE), with a
+	//! scalar fallback elsewhere.
+	class StrokeRecognizer {
+	  public:
+		static const int kNumPoints = 32;
+		
+		StrokeRecognizer();
+		
+		//! Adds a single stroke template. Returns the index reported in StrokeMatch::mTemplate, or -1 if the stroke is too short.
+		int					addTemplate( const std::string &name, const std::vector<ci::Vec2f> &points );
+		//! Adds a template drawn with several strokes
+		int					addTemplate( const std::string &name, const std::vector<std::vector<ci::Vec2f> > &strokes );
+		//! Adds the strokes recorded so far as a template
+		int					addRecordedTemplate( const std::string &name );
+		const std::string&	getTemplateName( int index ) const { return mNames[index]; }
+		int					numTemplates() const { return mNames.size(); }
+		bool				empty() const { return mNames.empty(); }
+		void				clear();
+		
+		//! Records touch positions, one stroke per touch id
+		void				addPoint( uint32_t strokeId, const ci::Vec2f &pos );
+		void				addPoints( const TouchPointSpan &touchPoints );
+		void				clearPoints();
+		int					numPoints() const { return mRawPoints.size(); }
+		
+		//! Matches the recorded strokes against every template. Returns false if none is within the max distance.
+		bool				recognize( StrokeMatch *match );
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Sets the largest StrokeMatch::mDistance recognized
+		void				setMaxDistance( float distance ) { mMaxDistance = distance; }
+		float				getMaxDistance() const { return mMaxDistance; }
+		//! Sets the shortest total stroke length recognized, measured in pixels. Shorter strokes are taps, not shapes.
+		void				setMinLength( float length ) { mMinLength = length; }
+		float				getMinLength() const { return mMinLength; }
+		
+	  private:
+		static const int	kFieldSize = 32;
+		static const int	kFieldCells = kFieldSize * kFieldSize;
+		static const int	kStartStep = 5;
+		static const int	kNumStarts = ( kNumPoints + kStartStep - 1 ) / kStartStep;
+		
+		struct RawPoint {
+			ci::Vec2f	mPos;
+			int			mStroke;
+			
+			bool operator<( const RawPoint &other ) const { return mStroke < other.mStroke; }
+		};
+		
+		//! Resamples strokes sorted by stroke into kNumPoints, scaled to a unit box and centered. Returns false if too short.
+		static bool			normalize( const std::vector<RawPoint> &points, float minLength, float *xs, float *ys, ci::Vec2f *center, float *size );
+		int					addNormalized( const std::string &name, const float *xs, const float *ys );
+		//! Writes the distance from each cell center to the nearest point, rounded down to 1 / kFieldScale
+		static void			buildField( const float *xs, const float *ys, uint8_t *field, uint16_t *cells );
+		//! Writes a lower bound of the weighted cloud distance for each start, given a lower bound of each point's distance
+		static void			calcStartBounds( const float *pointBounds, float *startBounds );
+		//! Writes the start bounds of template t, from the candidate's points then from the template's. Returns the least.
+		float				calcTemplateBounds( int t, float *startBounds ) const;
+		//! Writes the distance from each point of a to the nearest point of b
+		static void			calcNearestDistances( const float *ax, const float *ay, const float *bx, const float *by, float *distances );
+		//! Greedily matches each point from start on to its nearest unmatched point, abandoning once the sum reaches minSoFar
+		static float		calcCloudDistance( const float *ax, const float *ay, const float *bx, const float *by, int start, float minSoFar );
+		//! Returns the best distance of template t below minSoFar, or minSoFar
+		float				matchTemplate( int t, float minSoFar ) const;
+		
+		std::vector<std::string>	mNames;
+		// per-template points, the field cell of each point, and fields, kNumPoints or kFieldCells per template
+		std::vector<float>			mPointsX, mPointsY;
+		std::vector<uint16_t>		mPointCells;
+		std::vector<uint8_t>		mFields;
+		
+		std::vector<RawPoint>		mRawPoints, mSortedPoints;
+		std::vector<uint32_t>		mStrokeIds;
+		
+		// the candidate, normalized like the templates, and scratch reused across recognize() calls
+		float						mCandidateX[kNumPoints], mCandidateY[kNumPoints];
+		uint16_t					mCandidateCells[kNumPoints];
+		std::vector<uint8_t>		mCandidateField;
+		std::vector<std::pair<float, int> >	mOrder;
+		
+		float						mMaxDistance, mMinLength;
+	};
+	
+}
@@ -0,0 +1,97 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Timer.h"
+#include <boost/atomic.hpp>
+
+#include "TouchPointSet.h"
+
+namespace Pivot {
+	
+	//! Time source for TouchPivot velocities and delta times, in seconds. Only differences between readings matter.
+	class TouchClock {
+	  public:
+		virtual ~TouchClock() {}
+		
+		//! Returns the time of an update that delivered \a touchPoints, the touches just added, moved or removed
+		virtual double	getTime( const TouchPointSpan &touchPoints ) const = 0;
+		//! Returns the time now, between updates, on the same scale as getTime(). Used for timeouts while no touches change.
+		virtual double	getCurrentTime() const = 0;
+		
+		//! Returns the shared EventTouchClock, which TouchPivots use unless given another clock
+		static const TouchClock*	getDefault();
+	};
+	
+	
+	//! Reads the newest timestamp of the delivered touches, so velocities don't depend on when callbacks run.
+	//! Between updates, the current time carries on from the last timestamp read, by a steady wall clock. Safe to share between
+	//! threads. The last read always wins, so a source on an older time base, like a TouchPlayer replay, takes over at once.
+	class EventTouchClock : public TouchClock {
+	  public:
+		EventTouchClock() : mTimer( true ), mOffset( 0.0 ) {}
+		
+		double	getTime( const TouchPointSpan &touchPoints ) const;
+		double	getCurrentTime() const { return mTimer.getSeconds() + mOffset.load(); }
+		
+	  private:
+		ci::Timer						mTimer;
+		// the last timestamp read less the wall clock when it was, kept as one value so readers never see half an update
+		mutable boost::atomic<double>	mOffset;
+	};
+	
+	
+	//! Reads a steady wall clock when the update is handled. For touch sources without usable timestamps.
+	class MonotonicTouchClock : public TouchClock {
+	  public:
+		MonotonicTouchClock() : mTimer( true ) {}
+		
+		double	getTime( const TouchPointSpan &touchPoints ) const { return mTimer.getSeconds(); }
+		double	getCurrentTime() const { return mTimer.getSeconds(); }
+		
+	  private:
+		ci::Timer	mTimer;
+	};
+	
+	
+	//! Reads a time set by the caller, for tests and benchmarks that step faster or slower than real time
+	class VirtualTouchClock : public TouchClock {
+	  public:
+		VirtualTouchClock( double time = 0.0 ) : mTime( time ) {}
+		
+		double	getTime( const TouchPointSpan &touchPoints ) const { return mTime; }
+		double	getCurrentTime() const { return mTime; }
+		
+		void	setTime( double time ) { mTime = time; }
+		void	advance( double deltaTime ) { mTime += deltaTime; }
+		
+	  private:
+		double	mTime;
+	};
+	
+}
@@ -0,0 +1,104 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+#include <boost/unordered_map.hpp>
+#include <vector>
+
+#include "TouchObject.h"
+
+namespace Pivot {
+	
+	//! Groups touches into hands, and so users, as they land. A new touch joins the hand of the nearest touch within the link
+	//! distance, and touches landing together link through each other, so a spread hand stays one cluster. A hand lifted and
+	//! put back within the rejoin time keeps its cluster. Clusters never change once assigned, however hands move afterwards.
+	//! Neighbors are found through a hashed grid of link-sized cells, so clustering takes time linear in the number of touches.
+	class TouchClusterer {
+	  public:
+		TouchClusterer( float linkDistance = 200.0f, float rejoinTime = 0.5f );
+		
+		//! Assigns clusters to the new touches, all at once
+		void	touchesBegan( const TouchList &touches );
+		void	touchesMoved( const TouchList &touches );
+		//! Forgets ended or cancelled touches
+		void	touchesEnded( const TouchList &touches );
+		void	clear();
+		
+		//! Returns the cluster of a touch, or -1 if it isn't down
+		int		getCluster( uint32_t touchId ) const;
+		//! Returns the number of touches down in a cluster
+		int		getClusterSize( int cluster ) const;
+		int		numTouches() const { return mNodes.size(); }
+		int		numClusters() const { return mClusterSizes.size(); }
+		
+		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
+		
+		//! Farthest apart two touches of one hand may land, measured in pixels
+		void	setLinkDistance( float distance ) { mLinkDistance = distance; }
+		float	getLinkDistance() const { return mLinkDistance; }
+		//! Longest a hand may lift and still land back in the same cluster, measured in seconds
+		void	setRejoinTime( float seconds ) { mRejoinTime = seconds; }
+		float	getRejoinTime() const { return mRejoinTime; }
+		
+	  private:
+		struct Node {
+			uint32_t	mId;
+			ci::Vec2f	mPos;
+			int			mCluster;
+			//! Next node in the same grid bucket
+			int			mNext;
+		};
+		
+		//! A cluster whose touches all lifted, where and when the last one did
+		struct LiftedCluster {
+			int			mCluster;
+			ci::Vec2f	mPos;
+			double		mTime;
+		};
+		
+		//! Links every node into the grid buckets, sized for numNodes
+		void	buildGrid( int numNodes );
+		int		findBucket( int cellX, int cellY ) const;
+		int		findRoot( int node );
+		
+		std::vector<Node>						mNodes;
+		boost::unordered_map<uint32_t, int>		mNodeIndices;
+		boost::unordered_map<int, int>			mClusterSizes;
+		std::vector<LiftedCluster>				mLiftedClusters;
+		int										mNextCluster;
+		
+		// scratch reused between events: grid buckets, and the union-find forest and best join of each group of new nodes
+		std::vector<int>		mBuckets;
+		std::vector<int>		mParents, mJoinClusters, mRejoinIndices;
+		std::vector<float>		mJoinDistSq;
+		
+		float					mLinkDistance, mRejoinTime;
+	};
+	
+}
@@ -0,0 +1,69 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include <vector>
+
+#include "TouchPoint.h"
+
+namespace Pivot {
+	
+	//! Keeps the most recent samples of each active touch, including moves merged away by event coalescing
+	class TouchHistory {
+	  public:
+		static const int kCapacity = 32;
+		
+		TouchHistory() {}
+		
+		void		addSample( const ci::app::TouchEvent::Touch &touch );
+		//! Forgets all samples of a touch. Call once the touch has ended or been cancelled.
+		void		removeTouch( uint32_t id );
+		void		clear() { mTracks.clear(); }
+		
+		//! Returns the number of samples held for the touch, up to kCapacity
+		int			numSamples( uint32_t id ) const;
+		//! Returns a sample of the touch. Age 0 is the newest, numSamples() - 1 the oldest.
+		TouchSample	getSample( uint32_t id, int age ) const;
+		//! Estimates where the touch was, or will be, \a offset seconds after its newest sample. Negative offsets interpolate
+		//! between samples, positive ones extrapolate along a least-squares fit of the last \a window seconds.
+		ci::Vec2f	resample( uint32_t id, double offset, double window ) const;
+		
+	  private:
+		struct Track {
+			uint32_t	mId;
+			TouchSample	mSamples[kCapacity];
+			int			mHead, mCount;
+		};
+		
+		int			findTrack( uint32_t id ) const;
+		
+		std::vector<Track>	mTracks;
+	};
+	
+}
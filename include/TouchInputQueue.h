@@ -0,0 +1,75 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <vector>
+
+#include "TouchPoint.h"
+
+namespace Pivot {
+	
+	//! Lock-free single-producer/single-consumer queue of touch events. One thread pushes as touches arrive,
+	//! another (normally the main thread, before update) pops them. Never allocates once constructed.
+	class TouchInputQueue {
+	  public:
+		static const int kCapacity = 4096;
+		
+		TouchInputQueue();
+		
+		//! Producer side. Queues the touches as one event, keeping their timestamps. Returns false, dropping the whole event, if the queue is full.
+		bool		push( TouchPhase phase, const std::vector<ci::app::TouchEvent::Touch> &touches );
+		//! Producer side. Queues the touches as one event, stamped with the given time in seconds. For sources without timestamps of their own.
+		bool		push( TouchPhase phase, const std::vector<ci::app::TouchEvent::Touch> &touches, double time );
+		
+		//! Consumer side. Pops the oldest queued event. Returns false if there is none. Popped touches have no native data.
+		bool		pop( TouchPhase *phase, std::vector<ci::app::TouchEvent::Touch> *touches );
+		
+		//! Returns the number of events dropped because the queue was full
+		uint32_t	numDropped() const { return mNumDropped.load(); }
+		
+	  private:
+		struct Record {
+			ci::app::TouchEvent::Touch	mTouch;
+			TouchPhase					mPhase;
+			bool						mIsLastInEvent;
+		};
+		
+		//! Pass NULL to keep the touches' own timestamps
+		bool		pushEvent( TouchPhase phase, const std::vector<ci::app::TouchEvent::Touch> &touches, const double *time );
+		
+		//! Producer side. An event's records are built here, then published at once.
+		std::vector<Record>																mStaging;
+
+		boost::lockfree::spsc_queue<Record, boost::lockfree::capacity<kCapacity> >	mRecords;
+		boost::atomic<uint32_t>														mNumDropped;
+	};
+	
+}
@@ -30,27 +30,42 @@
 #include "cinder/app/TouchEvent.h"
 #include "cinder/Camera.h"
 #include "cinder/Color.h"
+#include "cinder/Rect.h"
 #include <list>
+#include <vector>
 
+#include "CameraSnapshot.h"
+#include "ChordClassifier.h"
+#include "GestureEngine.h"
+#include "GestureSpotter.h"
+#include "InertiaCurve.h"
+#include "LazyMember.h"
+#include "StrokeRecognizer.h"
 #include "TouchPivot.h"
 #include "TouchPoint.h"
+#include "TouchPointSet.h"
 
 namespace Pivot {
 	
 	typedef std::list<ci::app::TouchEvent::Touch> TouchList;
 	TouchList toList( const std::vector<ci::app::TouchEvent::Touch> &touches );
 	
+	class TouchScene;
+	class MomentumBatch;
+	
 	class TouchObject {
 	  public:
 		TouchObject();
 		TouchObject( bool captureTouches );
-		virtual ~TouchObject() {}
+		virtual ~TouchObject();
 		
-		//! Most TouchObjects will use this.
-		virtual void update( float deltaTime = 0.01667f ) {}
+		//! Most TouchObjects will use this. Advances momentum via integrate(), in fixed steps if enabled.
+		virtual void update( float deltaTime = 0.01667f );
 		
 		//! Evaluates if touches are within TouchObject's interactive range.
 		virtual bool hitTest( ci::app::TouchEvent::Touch touch ) { return false; }
+		//! Sets the screen-space rect enclosing the interactive range. Returns false if unbounded, so TouchScene always hit tests it.
+		virtual bool getBounds( ci::Rectf *bounds ) { return false; }
 		
 		//! Primary touch events -- these should hopefully cover 90% of any touch UI development
 		virtual void pivotBegan( TouchPivot *touchPivot ) {}
@@ -60,21 +75,74 @@ namespace Pivot {
 		virtual void pivotCancelled( TouchPivot *touchPivot ) {}    
 		
 		//! Secondary touch events -- for when you need granular touch point information
-		virtual void touchPointsBegan( std::list<TouchPoint> *allTouchPoints, std::list<TouchPoint> *changedTouchPoints, TouchPivot *touchPivot ) {}
-		virtual void touchPointsMoved( std::list<TouchPoint> *allTouchPoints, std::list<TouchPoint> *changedTouchPoints, TouchPivot *touchPivot ) {}
-		virtual void touchPointsEnded( std::list<TouchPoint> *allTouchPoints, std::list<TouchPoint> *changedTouchPoints, TouchPivot *touchPivot ) {}
-		virtual void touchPointsCancelled( std::list<TouchPoint> *allTouchPoints, std::list<TouchPoint> *changedTouchPoints, TouchPivot *touchPivot ) {}
+		virtual void touchPointsBegan( const TouchPointSpan &allTouchPoints, const TouchPointSpan &changedTouchPoints, TouchPivot *touchPivot ) {}
+		virtual void touchPointsMoved( const TouchPointSpan &allTouchPoints, const TouchPointSpan &changedTouchPoints, TouchPivot *touchPivot ) {}
+		virtual void touchPointsEnded( const TouchPointSpan &allTouchPoints, const TouchPointSpan &changedTouchPoints, TouchPivot *touchPivot ) {}
+		virtual void touchPointsCancelled( const TouchPointSpan &allTouchPoints, const TouchPointSpan &changedTouchPoints, TouchPivot *touchPivot ) {}
+		
+		//! Discrete gesture events -- taps, long presses, swipes and press-drags from the recognizers added below
+		virtual void gestureRecognized( const Gesture &gesture ) {}
+		
+		//! Runs a recognizer on this object's touches (see GestureEngine for how conflicts are settled). Returns its index, reported in Gesture::mRecognizer.
+		int					addGestureRecognizer( const GestureRecognizer &recognizer ) { return mGestureEngine.get().addRecognizer( recognizer ); }
+		GestureRecognizer&	getGestureRecognizer( int index ) { return mGestureEngine.get().getRecognizer( index ); }
+		void				clearGestureRecognizers() { mGestureEngine.reset(); }
+		
+		//! Shape events -- called once every touch lifts, if the strokes drawn match one of the templates added below
+		virtual void strokeRecognized( const StrokeMatch &match ) {}
+		
+		//! Records each touch's path as a stroke while templates are loaded (see StrokeRecognizer). Returns the template index.
+		int					addStrokeTemplate( const std::string &name, const std::vector<ci::Vec2f> &points ) { return mStrokeRecognizer.get().addTemplate( name, points ); }
+		int					addStrokeTemplate( const std::string &name, const std::vector<std::vector<ci::Vec2f> > &strokes ) { return mStrokeRecognizer.get().addTemplate( name, strokes ); }
+		StrokeRecognizer&	getStrokeRecognizer() { return mStrokeRecognizer.get(); }
+		void				clearStrokeTemplates() { mStrokeRecognizer.reset(); }
+		
+		//! Spotted gesture events -- called as soon as a template is drawn anywhere within a touch's path, lifted or not
+		virtual void gestureSpotted( const SpottedGesture &gesture ) {}
+		
+		//! Watches every touch's path for the template while it's down (see GestureSpotter). Returns the template index.
+		int					addSpottingTemplate( const std::string &name, const std::vector<ci::Vec2f> &points ) { return mGestureSpotter.get().addTemplate( name, points ); }
+		GestureSpotter&		getGestureSpotter() { return mGestureSpotter.get(); }
+		void				clearSpottingTemplates() { mGestureSpotter.reset(); }
+		
+		//! Chord events -- called on every move with the class of the whole touch set, once examples are added below
+		virtual void chordClassified( const Chord &chord ) {}
+		
+		//! Adds the current touches as an example of the named chord (see ChordClassifier). Returns the class index.
+		int					addChordExample( const std::string &className ) { return mChordClassifier.get().addExample( className, mTouchPoints.getSpan() ); }
+		ChordClassifier&	getChordClassifier() { return mChordClassifier.get(); }
+		void				clearChordExamples() { mChordClassifier.reset(); }
 		
 		//! TouchEvents must be passed to TouchObject for it to be aware of incoming touches
 		void	touchesBegan( TouchList *touches );
 		void	touchesMoved( TouchList *touches );
 		void	touchesEnded( TouchList *touches );
 		void	touchesCancelled( TouchList *touches );
-		void	touchesCancelled( std::list<TouchPoint>	*touchPoints );
+		void	touchesCancelled( TouchPointSet *touchPoints );
+		//! Adds touches that have already passed hitTest, skipping the hit test in touchesBegan. Used by TouchScene.
+		void	acceptTouches( const std::vector<ci::app::TouchEvent::Touch> &touches );
+		//! Updates touches already owned by this TouchObject, without touching any TouchList. Used by TouchScene.
+		void	moveTouches( const std::vector<ci::app::TouchEvent::Touch> &touches );
+		void	endTouches( const std::vector<ci::app::TouchEvent::Touch> &touches );
+		void	cancelTouches( const std::vector<ci::app::TouchEvent::Touch> &touches );
+		
+		//! Returns the TouchScene this TouchObject is registered with, or NULL
+		TouchScene*	getScene() const { return mSceneLink.mScene; }
+		//! Returns the MomentumBatch integrating this TouchObject, or NULL. While in one, update() does nothing.
+		MomentumBatch*	getMomentumBatch() const { return mMomentumLink.mBatch; }
 		
-		//! Allows the assignment of different types of TouchPivots (BasicPivot, RotationPivot, FullPivot, AdvancedPivot)
+		//! Allows the assignment of different types of TouchPivots (BasicPivot, RotationPivot, FullPivot)
 		void		setTouchPivot( TouchPivot touchPivot ) { mTouchPivot = touchPivot; }
-		TouchPivot	getTouchPivot() const { return mTouchPivot; }
+		const TouchPivot&	getTouchPivot() const { return mTouchPivot; }
+		//! Shares a touch sample history with the TouchPivot, for more accurate release velocities
+		void		setTouchHistory( const TouchHistory *touchHistory ) { mTouchPivot.setTouchHistory( touchHistory ); }
+		//! Sets the time source the TouchPivot measures velocities with. NULL restores the touch event timestamps.
+		void		setTouchClock( const TouchClock *touchClock ) { mTouchPivot.setTouchClock( touchClock ); }
+		//! Fits the TouchPivot's release velocities to every move's timestamp (see TouchPivot::setVelocityEstimator)
+		void		setVelocityEstimator( const VelocityEstimator &estimator ) { mTouchPivot.setVelocityEstimator( estimator ); }
+		//! Smooths the TouchPivot's pose before the pivot callbacks read it (see TouchPivot::enableFilter)
+		void		enablePivotFilter( float minCutoff = 1.0f, float beta = 0.007f, float derivativeCutoff = 1.0f ) { mTouchPivot.enableFilter( minCutoff, beta, derivativeCutoff ); }
+		void		disablePivotFilter() { mTouchPivot.disableFilter(); }
 		
 		//! Sets the capture mode of the TouchObject.  Captured touches are removed from the TouchEvent list.
         // TODO: capture mode should be these enums: ALWAYS, DRAG, NEVER
@@ -82,6 +150,14 @@ namespace Pivot {
 		void	disableCaptureMode() { mCapturingTouches = false; }
 		bool	getCaptureMode() { return mCapturingTouches; }
 		
+		//! Lets the touches of only one hand drive this TouchObject at a time, when its TouchScene clusters touches (see TouchScene::enableClustering).
+		//! Touches from other clusters pass through to the TouchObjects behind.
+		void	enableSingleCluster( bool singleCluster = true ) { mSingleCluster = singleCluster; }
+		void	disableSingleCluster() { mSingleCluster = false; }
+		bool	isSingleCluster() const { return mSingleCluster; }
+		//! Returns the cluster of the touches driving this TouchObject, or -1
+		int		getCluster() const { return mCluster; }
+		
 		//! Returns true if the TouchPivot is currently active
 		bool	isActive() const { return mTouchPivot.isActive(); }
 		//! Returns true if the TouchPivot has broken it's dragging threshold
@@ -90,18 +166,28 @@ namespace Pivot {
 		bool	isInMotion() { return mIsInMotion; }
 		
 		//! Returns all touches watched by this TouchObject
-		std::list<TouchPoint>	getTouchPoints() const { return mTouchPoints; }
+		const TouchPointSet&	getTouchPoints() const { return mTouchPoints; }
 		
-		//! Velocity decay is a diminishment factor per second.  Must be a value between 0 and 1, not inclusive.
-		void			setVelDecay( float velDecay ) { mVelDecay = velDecay; }
+		//! Velocity decay is a diminishment factor per 60 fps frame.  Must be a value between 0 and 1, not inclusive.
+		//! Momentum decays exponentially at the matching rate whatever the actual frame rate (see getInertiaCurve()).
+		void			setVelDecay( float velDecay );
 		float			getVelDecay() { return mVelDecay; }
+		InertiaCurve	getInertiaCurve() const { return InertiaCurve::fromVelDecay( mVelDecay ); }
+		
+		//! Integrates momentum in steps of 1 / stepsPerSecond whatever the frame rate, at most maxSteps per update; any backlog beyond that is dropped.
+		//! Pose getters (getPos, getRot, getOrientation...) then blend the last two steps, for rendering between them. Does nothing in a MomentumBatch.
+		void			enableFixedTimestep( float stepsPerSecond = 120.0f, int maxSteps = 8 );
+		void			disableFixedTimestep() { mFixedStep = 0.0f; mStepAlpha = 1.0f; }
+		bool			isFixedTimestep() const { return mFixedStep > 0.0f; }
+		//! Fraction of a fixed step elapsed since the last one. Always 1 without a fixed timestep.
+		float			getStepAlpha() const { return mStepAlpha; }
 		
 		//! Debug convenience functions
 		void			setDebugColor( ci::Color debugColor ) { mDebugColor = debugColor; }
 		ci::Color		getDebugColor() { return mDebugColor; }
 		
 	  protected:
-		std::list<TouchPoint>	mTouchPoints;
+		TouchPointSet			mTouchPoints;
 		TouchPivot				mTouchPivot;
 		
 		bool					mCapturingTouches, mIsInMotion;
@@ -109,6 +195,19 @@ namespace Pivot {
 		
 		float					mVelDecay;
 		
+		float					mFixedStep, mStepAccumulator, mStepAlpha;
+		int						mMaxSteps;
+		
+		//! Advances momentum by deltaTime. Called from update(), once per fixed step when enabled.
+		virtual void			integrate( float deltaTime ) {}
+		//! Keeps the current pose as the previous one, for the interpolating pose getters. Called before each fixed step.
+		virtual void			storePrevPose() {}
+		//! Brings the momentum velocities up to date when a MomentumBatch holds them. Call before reading or changing them outside integrate().
+		void					fetchMomentum();
+		
+		//! Notifies the TouchScene (if any) that getBounds() has changed. Call whenever the interactive area moves or resizes.
+		void					markBoundsDirty();
+		
 		static float limit( float value, float strength, float min, float max, float deltaTime = 0.0f )
 		{
 			if ( value > max ) {
@@ -122,19 +221,80 @@ namespace Pivot {
 			}
 		}
 		
+	  private:
+		friend class TouchScene;
+		friend class MomentumBatch;
+		
+		void	beginTouchPoints( const TouchPointSet &changedTouchPoints, bool isPivotReset );
+		void	moveTouchPoints( const TouchPointSet &changedTouchPoints );
+		void	endTouchPoints( const TouchPointSet &changedTouchPoints );
+		void	cancelTouchPoints( const TouchPointSet &changedTouchPoints );
+		void	addTouchPoint( const ci::app::TouchEvent::Touch &touch, TouchPointSet *addedTouchPoints );
+		bool	moveTouchPoint( const ci::app::TouchEvent::Touch &touch, TouchPointSet *changedTouchPoints );
+		bool	removeTouchPoint( const ci::app::TouchEvent::Touch &touch, TouchPointSet *removedTouchPoints );
+		//! Returns true if a touch of the cluster may begin on this TouchObject, which then holds on to that cluster. Used by TouchScene.
+		bool	acceptsCluster( int cluster );
+		//! Called after the pivot callbacks of every touch change
+		void	touchPoseChanged();
+		//! Delivers the gestures the engine reported to gestureRecognized()
+		void	dispatchGestures();
+		//! Delivers the gestures the spotter reported to gestureSpotted()
+		void	dispatchSpottedGestures();
+		static ci::Vec2f	calcCentroid( const TouchPointSpan &touchPoints, const TouchPointSpan &moreTouchPoints );
+		
+		//! Gesture, stroke, spotting and chord engines, allocated by the first template, recognizer or example added to them
+		LazyMember<GestureEngine>		mGestureEngine;
+		LazyMember<StrokeRecognizer>	mStrokeRecognizer;
+		LazyMember<GestureSpotter>		mGestureSpotter;
+		LazyMember<ChordClassifier>		mChordClassifier;
+		
+		bool					mSingleCluster;
+		int						mCluster;
+		
+		//! Scene membership belongs to the instance, so it's never copied along with the rest of a TouchObject
+		struct SceneLink {
+			SceneLink() : mScene( NULL ), mOwner( NULL ), mIndex( -1 ) {}
+			SceneLink( const SceneLink &other ) : mScene( NULL ), mOwner( NULL ), mIndex( -1 ) {}
+			SceneLink& operator=( const SceneLink &other );
+			void reset() { mScene = NULL; mOwner = NULL; mIndex = -1; }
+			
+			TouchScene		*mScene;
+			TouchObject		*mOwner;
+			int				mIndex;
+		};
+		SceneLink				mSceneLink;
+		
+		//! MomentumBatch membership, likewise never copied
+		struct MomentumLink {
+			MomentumLink() : mBatch( NULL ), mKind( 0 ), mLane( -1 ), mIsActive( false ), mNeedsGather( false ) {}
+			MomentumLink( const MomentumLink &other ) : mBatch( NULL ), mKind( 0 ), mLane( -1 ), mIsActive( false ), mNeedsGather( false ) {}
+			MomentumLink& operator=( const MomentumLink &other ) { return *this; }
+			
+			MomentumBatch	*mBatch;
+			int				mKind, mLane;
+			//! mNeedsGather is set while the object's own velocities are newer than its lane's
+			bool			mIsActive, mNeedsGather;
+		};
+		MomentumLink			mMomentumLink;
 	};
 	
 	
 	class TouchObject3D : public TouchObject {
 	  public:
 		TouchObject3D() {}
-		TouchObject3D( ci::CameraPersp cam, bool captureTouches );
+		TouchObject3D( const ci::CameraPersp &cam, bool captureTouches );
+		TouchObject3D( const ci::CameraPersp &cam, const ci::Vec2f &viewSize, bool captureTouches );
 		
-		void				setCamera( ci::CameraPersp cam ) { mCam = cam; }
-		ci::CameraPersp		getCamera() { return mCam; }
+		//! Cheap to call every frame. The camera is only copied, and its projection snapshot rebuilt, when it changes.
+		//! Without a view size, uses the window size, or the last view size when there's no App.
+		void					setCamera( const ci::CameraPersp &cam );
+		void					setCamera( const ci::CameraPersp &cam, const ci::Vec2f &viewSize );
+		const ci::CameraPersp&	getCamera() const { return mCam; }
+		const CameraSnapshot&	getProjection() const { return mProjection; }
 		
 	  protected:
 		ci::CameraPersp				mCam;
+		CameraSnapshot				mProjection;
 	};
 	
 }
@@ -28,26 +28,58 @@
 #pragma once
 
 #include "cinder/app/App.h"
-#include <boost/circular_buffer.hpp>
-#include <list>
+#include <vector>
 
-#include "TouchPoint.h"
+#include "LazyMember.h"
+#include "TouchClock.h"
+#include "TouchHistory.h"
+#include "TouchPointSet.h"
+#include "OneEuroFilter.h"
+#include "RingAverage.h"
+#include "VelocityEstimator.h"
 
 namespace Pivot {
 
-	// TODO: make this a base class that more advanced TouchPivots can extend
 	class TouchPivot {
 	  public:
-		TouchPivot();
+		//! Transforms a pivot fits besides translation, which it always tracks. Untracked ones stay at rest (rotation 0, scale 1).
+		enum Transforms { TRANSLATE = 0, ROTATE = 1 << 0, SCALE = 1 << 1, TRANSLATE_ROTATE_SCALE = ROTATE | SCALE };
+		
+		//! Each combination of \a transforms has a solver of its own, compiled without the math the others need
+		explicit TouchPivot( int transforms = TRANSLATE_ROTATE_SCALE );
 		virtual	~TouchPivot() {}
 		
-		virtual void touchPointsBegan( std::list<TouchPoint> *currentTouchPoints, std::list<TouchPoint> *addedTouchPoints );
-		virtual bool touchPointsMoved( std::list<TouchPoint> *currentTouchPoints, std::list<TouchPoint> *changedTouchPoints );
-		virtual void touchPointsEnded( std::list<TouchPoint> *currentTouchPoints, std::list<TouchPoint> *removedTouchPoints );
-		virtual void touchPointsCancelled( std::list<TouchPoint> *currentTouchPoints, std::list<TouchPoint> *cancelledTouchPoints ) { touchPointsEnded( currentTouchPoints, cancelledTouchPoints ); }
+		virtual void touchPointsBegan( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &addedTouchPoints );
+		virtual bool touchPointsMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints );
+		virtual void touchPointsEnded( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &removedTouchPoints );
+		virtual void touchPointsCancelled( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &cancelledTouchPoints ) { touchPointsEnded( currentTouchPoints, cancelledTouchPoints ); }
 		
 		// TODO: remove this when things are in a better state
-		virtual void	draw();
+		virtual void	draw() const;
+		
+		//! Optional per-touch sample history (see AppTouch::enableTouchCoalescing). Lets a single touch's release velocity use every sample, not just one per event.
+		void			setTouchHistory( const TouchHistory *touchHistory ) { mTouchHistory = touchHistory; }
+		const TouchHistory*	getTouchHistory() const { return mTouchHistory; }
+		
+		//! Time source for every velocity and delta time. Defaults to the touch event timestamps (see TouchClock::getDefault()).
+		void			setTouchClock( const TouchClock *touchClock ) { mTouchClock = touchClock ? touchClock : TouchClock::getDefault(); }
+		const TouchClock*	getTouchClock() const { return mTouchClock; }
+		
+		//! Fits release velocities to every move's timestamp with copies of \a estimator, so flicks feel the same at any event rate.
+		//! Off by default, which averages the last few moves instead. The estimators are allocated by the first call.
+		void			setVelocityEstimator( const VelocityEstimator &estimator );
+		void			disableVelocityEstimator() { mIsVelocityEstimated = false; }
+		bool			isVelocityEstimated() const { return mIsVelocityEstimated; }
+		
+		//! Smooths getPos(), getRot() and getScale() with OneEuroFilters on the pivot's clock. \a beta is per pixel per second of finger speed;
+		//! rotation and scale scale it by the touches' spread. Release velocities still come from the unfiltered motion.
+		//! The filters are allocated by the first call.
+		void			enableFilter( float minCutoff = 1.0f, float beta = 0.007f, float derivativeCutoff = 1.0f );
+		void			disableFilter() { mIsFiltered = false; }
+		bool			isFiltered() const { return mIsFiltered; }
+		
+		//! Returns the Transforms fit by the pivot
+		int				getTransforms() const { return mTransforms; }
 		
 		//! Returns number of TouchPoints currently being watched
 		int				numTouchPoints() const { return mNumTouchPoints; }
@@ -57,10 +89,7 @@ namespace Pivot {
 		bool			isDragging() const { return mIsDragging; }
 		
 		//! Returns the timestamp associated with the pivot, measured in seconds from last activation
-		double	getTime() const { 
-			if ( ! isActive() ) return 0.0;
-			return ci::app::getElapsedSeconds() - mBeginTime;
-		}
+		double			getTime() const { return mTime; }
 		//! Returns the timestamp associated with the previous pivot position, measured in seconds from last activation
 		double			getPrevTime() const { return mPrevTime; }
 		
@@ -68,21 +97,21 @@ namespace Pivot {
 		// EXTENDED GETTERS ///////////////////////////////////////////////////
 		
 		//! Returns the position of the pivot measured in pixels
-		ci::Vec2f		getPos() const { return mPos; }
+		ci::Vec2f		getPos() const { return mIsFiltered ? mFilters->mPos.getValue() : mPos; }
 		//! Returns	the position of last pivot reset, measured in pixels
 		ci::Vec2f		getResetPos() const { return mResetPos; }
 		//! Returns the release position velocity of the pivot measured in pixels per second
 		ci::Vec2f		getReleasePosVel() const { return mReleasePosVel; }
 		
 		//! Returns the rotation of the pivot measured in radians
-		float			getRot() const { return mRot; }
+		float			getRot() const { return mIsFiltered ? mFilters->mRot.getValue() : mRot; }
 		//! Returns the scale of the last pivot reset, measured in radians
 		float			getResetRot() const { return mResetRot; }
 		//! Returns the release rotation velocity of the pivot measured in radians per second
 		float			getReleaseRotVel() const { return mReleaseRotVel; }
 		
 		//! Returns the scale of the pivot measured as ratio
-		float			getScale() const { return mScale; }
+		float			getScale() const { return mIsFiltered ? mFilters->mScale.getValue() : mScale; }
 		//! Returns the scale of the last pivot reset, measured as ratio
 		float			getResetScale() const { return mResetScale; }
 		//! Returns the release scale velocity of the pivot measured as ratio per second
@@ -157,10 +186,32 @@ namespace Pivot {
 		
 		
 	  protected:
-		void								setBufferLengths( int len );
-		boost::circular_buffer<ci::Vec2f>	mPosAvgVel;
-		boost::circular_buffer<float>		mRotAvgVel, mScaleAvgVel;
-		boost::circular_buffer<double>		mDeltaTimeAvg;
+		static const int	kMaxBufferLength = 16;
+		
+		//! Number of recent moves release velocities are averaged over, up to kMaxBufferLength
+		void				setBufferLengths( int len );
+		RingAverage<ci::Vec2f, kMaxBufferLength>	mPosAvgVel;
+		RingAverage<float, kMaxBufferLength>		mRotAvgVel, mScaleAvgVel;
+		RingAverage<double, kMaxBufferLength>		mDeltaTimeAvg;
+		
+		struct VelocityEstimators {
+			VelocityEstimator	mPosX, mPosY, mRot, mScale;
+		};
+		struct PoseFilters {
+			OneEuroFilter<ci::Vec2f>	mPos;
+			OneEuroFilter<float>		mRot, mScale;
+		};
+		
+		//! Only allocated once enabled, so pivots that never fit or filter stay small. Set whenever their flag is.
+		bool							mIsVelocityEstimated;
+		LazyMember<VelocityEstimators>	mVelocityEstimators;
+		void				resetVelocityEstimators();
+		void				addVelocitySamples();
+		
+		bool							mIsFiltered;
+		LazyMember<PoseFilters>			mFilters;
+		//! Feeds the pose to the filters. With \a reset, starts them over at it, for where the pose jumps on purpose.
+		void				filterPose( bool reset );
 		
 		ci::Vec2f		mPos, mResetPos, mReleasePosVel;
 		float			mRot, mResetRot, mReleaseRotVel;
@@ -178,14 +229,58 @@ namespace Pivot {
 		float			mStartSpreadThreshold, mStartSpreadThresholdAugment, mReleaseSpreadVelThreshold, mReleaseSpreadVelMax;
 		double			mReleaseDeltaTimeThreshold, mReleaseDeltaTimeMax, mReleaseDeltaTimeMin;
 		
-		void			setPivotMoved( std::list<TouchPoint> *touchPoints );
-		float			calcVecAngleDiff( ci::Vec2f a, ci::Vec2f b );
-		float			calcVecScaleDiff( ci::Vec2f a, ci::Vec2f b );
-		float			calcNumAvg( boost::circular_buffer<float> numBuffer );
-		ci::Vec2f		calcPointAvg( boost::circular_buffer<ci::Vec2f> vecBuffer );
-		double			calcDeltaTimeAvg( boost::circular_buffer<double> numBuffer );
+		void			setPivotMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints );
+		template<bool Rotate, bool Scale>
+		void			setPivotMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints );
+		ci::Vec2f		calcCompositePos( const TouchPointSpan &touchPoints );
+		bool			calcHistoryPosVel( uint32_t id, ci::Vec2f *vel ) const;
+		double			calcTime( const TouchPointSpan &touchPoints ) const;
+		
+		const TouchHistory	*mTouchHistory;
+		const TouchClock	*mTouchClock;
 		
 		ci::Vec2f		mNode1, mResetNode1, mNode2, mResetNode2;
+		
+		//! One touch of the least-squares similarity fit: its offset from the centroid at the last reset, and where it is now
+		struct FitNode {
+			uint32_t	mId;
+			ci::Vec2f	mResetOffset, mPos;
+		};
+		
+		//! Starts a new fit at the touches' current positions
+		void			resetFit( const TouchPointSpan &touchPoints );
+		//! Updates the running moments for the touches that moved. O(1) per touch. Without \a Moments, only the centroid.
+		template<bool Moments>
+		void			moveFit( const TouchPointSpan &changedTouchPoints );
+		FitNode&		getFitNode( int i ) { return i < TouchPointSet::kInlineCapacity ? mFitNodes[i] : mSpilledFitNodes[i - TouchPointSet::kInlineCapacity]; }
+		
+		int				mTransforms;
+		
+		//! Held inline like TouchPointSet's touches; only nodes past its inline capacity spill to the heap
+		FitNode					mFitNodes[TouchPointSet::kInlineCapacity];
+		std::vector<FitNode>	mSpilledFitNodes;
+		int						mNumFitNodes;
+		// sum of positions, and of reset offsets dotted and crossed with positions
+		double			mFitSumX, mFitSumY, mFitDot, mFitCross, mFitResetSpread;
+	};
+	
+	
+	//! Translation only, for scrollers and sliders. Never pays for angle or length math.
+	class BasicPivot : public TouchPivot {
+	  public:
+		BasicPivot() : TouchPivot( TRANSLATE ) {}
+	};
+	
+	//! Translation and rotation, at a fixed scale
+	class RotationPivot : public TouchPivot {
+	  public:
+		RotationPivot() : TouchPivot( ROTATE ) {}
+	};
+	
+	//! Translation, rotation and uniform scale. Same as a default TouchPivot.
+	class FullPivot : public TouchPivot {
+	  public:
+		FullPivot() : TouchPivot( TRANSLATE_ROTATE_SCALE ) {}
 	};
 
 }
@@ -0,0 +1,89 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include "cinder/Filesystem.h"
+#include <functional>
+#include <vector>
+
+#include "TouchPoint.h"
+#include "TouchRecorder.h"
+
+namespace Pivot {
+	
+	class AppTouch;
+	class TouchObject;
+	class TouchScene;
+	
+	//! Plays a TouchRecorder recording back into an AppTouch, TouchScene, TouchObject or any other target,
+	//! either as fast as possible or in step with the original timing.
+	class TouchPlayer {
+	  public:
+		typedef std::function<void ( TouchPhase, const ci::app::TouchEvent& )>	Target;
+		
+		TouchPlayer();
+		
+		//! Reads a whole recording into memory. Returns false if the file is missing or not a recording.
+		bool	load( const ci::fs::path &path );
+		//! Plays from memory the caller owns, such as a memory-mapped file. The memory must outlive the player.
+		bool	load( const void *data, size_t size );
+		
+		void	setTarget( const Target &target ) { mTarget = target; }
+		void	setTarget( AppTouch *app );
+		void	setTarget( TouchScene *scene );
+		void	setTarget( TouchObject *object );
+		
+		//! Delivers every remaining event immediately, with its recorded timestamps
+		void	playAll();
+		
+		//! Starts real time playback at the given time, normally getElapsedSeconds(). Timestamps are shifted to match.
+		void	start( double time );
+		//! Delivers every event due by the given time. Call once per frame.
+		void	update( double time );
+		bool	isDone() const { return mNextRecord >= mNumRecords; }
+		void	rewind() { mNextRecord = 0; }
+		
+		uint32_t	numRecords() const { return mNumRecords; }
+		//! Returns the length of the recording, measured in seconds
+		double		getDuration() const;
+		
+	  private:
+		//! Delivers the next event, with timeOffset added to its timestamps
+		void	playEvent( double timeOffset );
+		
+		std::vector<char>		mOwnedData;
+		const TouchFileRecord	*mRecords;
+		uint32_t				mNumRecords, mNextRecord;
+		double					mTimeOffset;
+		
+		Target									mTarget;
+		std::vector<ci::app::TouchEvent::Touch>	mTouches;
+	};
+	
+}
@@ -30,11 +30,33 @@
 #include "cinder/Vector.h"
 
 namespace Pivot {
+	
+	enum TouchPhase { TOUCH_BEGAN, TOUCH_MOVED, TOUCH_ENDED, TOUCH_CANCELLED };
 		
+	//! Compact 16 byte touch record: position, id and a timestamp quantized to 1/10000th of a second
+	struct TouchSample {
+		static const uint32_t kTicksPerSecond = 10000;
+		
+		TouchSample() {}
+		TouchSample( const ci::Vec2f &pos, uint32_t id, double time ) : mPos( pos ), mId( id ), mTicks( toTicks( time ) ) {}
+		
+		//! Returns the timestamp measured in seconds, modulo the tick wrap
+		double			getTime() const { return mTicks / double( kTicksPerSecond ); }
+		//! Ticks wrap modulo 2^32, about every 4.97 days. Compare samples by uint32_t difference, which stays exact across the wrap.
+		//! Converts through int64_t, since a double beyond the uint32_t range is undefined to convert directly.
+		static uint32_t	toTicks( double time ) { return uint32_t( int64_t( time * kTicksPerSecond + ( time < 0.0 ? -0.5 : 0.5 ) ) ); }
+		
+		ci::Vec2f	mPos;
+		uint32_t	mId;
+		uint32_t	mTicks;
+	};
+	
+	
 	class TouchPoint {
 	  public:
+		TouchPoint() {}
 		TouchPoint( const ci::Vec2f &pos, const ci::Vec2f &prevPos, const ci::Vec2f &originPos, uint32_t id, double time, const void *native )
-		: mPos( pos ), mPrevPos( prevPos ), mId( id ), mTime( time ), mPrevTime( time ), mNative( native ) {}
+		: mPos( pos ), mPrevPos( prevPos ), mOriginPos( originPos ), mId( id ), mTime( time ), mPrevTime( time ), mNative( native ) {}
 		
 		//! Returns the position of the touch measured in pixels
 		ci::Vec2f	getPos() const { return mPos; }
@@ -48,8 +70,8 @@ namespace Pivot {
 		ci::Vec2f	getOriginPos() const { return mOriginPos; }
 		//! Sets the original position of the touch measured in pixels
 		void		setOriginPos( const ci::Vec2f &originPos ) { mOriginPos = originPos; }
-		//! Returns the position velocity of the touch measured in pixels per second
-		ci::Vec2f	getPosVel() const { return ( mPos - mPrevPos ) / ( mTime - mPrevTime ); }
+		//! Returns the position velocity of the touch measured in pixels per second, or zero for a move that took no time
+		ci::Vec2f	getPosVel() const { return ( mTime > mPrevTime ) ? ( mPos - mPrevPos ) / float( mTime - mPrevTime ) : ci::Vec2f::zero(); }
 		//! Returns the timestamp associated with the touch, measured in seconds
 		double		getTime() const { return mTime; }
 		//! Sets the timestamp associated with the touch, measured in seconds
@@ -62,6 +84,8 @@ namespace Pivot {
 		uint32_t	getId() const { return mId; }
 		//! Returns a pointer to the OS-native object. This is a UITouch* on Cocoa Touch and a TOUCHPOINT* on MSW.
 		const void*	getNative() const { return mNative; }
+		//! Returns the compact position, id and time of the touch
+		TouchSample	getSample() const { return TouchSample( mPos, mId, mTime ); }
 		
 	  private:
 		ci::Vec2f	mPos, mPrevPos, mOriginPos;
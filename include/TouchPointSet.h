@@ -0,0 +1,103 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Vector.h"
+
+#include "TouchPoint.h"
+
+namespace Pivot {
+	
+	//! Read-only view of contiguous TouchPoints and their parallel TouchSamples. Cheap to copy, never owns memory.
+	class TouchPointSpan {
+	  public:
+		typedef const TouchPoint*	const_iterator;
+		
+		TouchPointSpan() : mPoints( NULL ), mSamples( NULL ), mSize( 0 ) {}
+		TouchPointSpan( const TouchPoint *points, const TouchSample *samples, int size ) : mPoints( points ), mSamples( samples ), mSize( size ) {}
+		
+		const_iterator		begin() const { return mPoints; }
+		const_iterator		end() const { return mPoints + mSize; }
+		int					size() const { return mSize; }
+		bool				empty() const { return mSize == 0; }
+		const TouchPoint&	operator[]( int i ) const { return mPoints[i]; }
+		const TouchPoint&	front() const { return mPoints[0]; }
+		
+		//! Returns the compact records parallel to the TouchPoints, for tight loops over positions
+		const TouchSample*	getSamples() const { return mSamples; }
+		
+	  private:
+		const TouchPoint	*mPoints;
+		const TouchSample	*mSamples;
+		int					mSize;
+	};
+	
+	
+	//! Ordered set of TouchPoints stored contiguously. Holds up to kInlineCapacity touches without touching the heap.
+	class TouchPointSet {
+	  public:
+		static const int kInlineCapacity = 10;
+		
+		typedef const TouchPoint*	const_iterator;
+		
+		TouchPointSet();
+		TouchPointSet( const TouchPointSet &other );
+		~TouchPointSet();
+		TouchPointSet& operator=( const TouchPointSet &other );
+		
+		const_iterator		begin() const { return mPoints; }
+		const_iterator		end() const { return mPoints + mSize; }
+		int					size() const { return mSize; }
+		bool				empty() const { return mSize == 0; }
+		const TouchPoint&	operator[]( int i ) const { return mPoints[i]; }
+		const TouchPoint&	front() const { return mPoints[0]; }
+		const TouchPoint&	back() const { return mPoints[mSize - 1]; }
+		const TouchSample*	getSamples() const { return mSamples; }
+		TouchPointSpan		getSpan() const { return TouchPointSpan( mPoints, mSamples, mSize ); }
+		
+		//! Returns the slot holding the touch with the given id, or -1
+		int		find( uint32_t id ) const;
+		void	push_back( const TouchPoint &touchPoint );
+		//! Removes the touch in the given slot, keeping the order of the remaining touches
+		void	erase( int slot );
+		void	clear() { mSize = 0; }
+		
+		//! Moves the touch in the given slot, shifting its current position and time to the previous ones
+		void	move( int slot, const ci::Vec2f &pos, const ci::Vec2f &prevPos, double time );
+		
+	  private:
+		void	reserve( int capacity );
+		
+		TouchPoint		mInlinePoints[kInlineCapacity];
+		TouchSample		mInlineSamples[kInlineCapacity];
+		TouchPoint		*mPoints;
+		TouchSample		*mSamples;
+		int				mSize, mCapacity;
+	};
+	
+}
@@ -0,0 +1,101 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/app/TouchEvent.h"
+#include "cinder/Filesystem.h"
+#include <cstdio>
+#include <vector>
+
+#include "TouchPoint.h"
+
+namespace Pivot {
+	
+	//! On-disk layout of a touch recording: one TouchFileHeader followed by fixed size TouchFileRecords,
+	//! in host (little-endian) byte order, so a recording can be memory-mapped and read as an array.
+	struct TouchFileHeader {
+		static const uint32_t kMagic = 0x48435454; // "TTCH"
+		static const uint32_t kVersion = 1;
+		
+		uint32_t	mMagic;
+		uint32_t	mVersion;
+		uint32_t	mHeaderSize;
+		uint32_t	mRecordSize;
+		uint32_t	mNumRecords;
+		uint32_t	mReserved[3];
+	};
+	
+	struct TouchFileRecord {
+		enum { LAST_IN_EVENT = 1 };
+		
+		double		mTime;
+		float		mPosX, mPosY, mPrevPosX, mPrevPosY;
+		uint32_t	mId;
+		uint8_t		mPhase;
+		uint8_t		mFlags;
+		uint16_t	mReserved;
+	};
+	
+	
+	//! Writes every touch event it's given to a binary recording, with exact timestamps. See AppTouch::setTouchRecorder().
+	//! AppTouch records touches as it dispatches them, after palm rejection: rejected touches are left out and the cancels it
+	//! sends in their place are kept, so a replay reproduces what the app saw but can't run the rejection again.
+	class TouchRecorder {
+	  public:
+		TouchRecorder();
+		~TouchRecorder();
+		
+		//! Starts a new recording, replacing any file at path. Returns false if the file can't be opened.
+		bool	open( const ci::fs::path &path );
+		//! Writes out buffered records and finalizes the header. Returns false if any write failed since open(), leaving the
+		//! recording incomplete.
+		bool	close();
+		bool	isOpen() const { return mFile != NULL; }
+		//! Returns true once a write has failed, such as on a full disk. Later records are dropped until the next open().
+		bool	hasFailed() const { return mHasFailed; }
+		
+		void		record( TouchPhase phase, const std::vector<ci::app::TouchEvent::Touch> &touches );
+		uint32_t	numRecords() const { return mNumRecords; }
+		
+	  private:
+		// copying would write the same file twice
+		TouchRecorder( const TouchRecorder& );
+		TouchRecorder& operator=( const TouchRecorder& );
+		
+		//! Returns false if the buffered records couldn't all be written
+		bool	flush();
+		
+		static const int				kBufferSize = 256;
+		
+		FILE							*mFile;
+		std::vector<TouchFileRecord>	mBuffer;
+		uint32_t						mNumRecords;
+		bool							mHasFailed;
+	};
+	
+}
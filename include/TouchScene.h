@@ -0,0 +1,195 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+#include "cinder/Rect.h"
+#include <boost/unordered_map.hpp>
+#include <vector>
+
+#include "TouchObject.h"
+#include "TouchClusterer.h"
+
+namespace Pivot {
+	
+	//! Owns TouchObject registration and depth order, and culls hit tests with a uniform grid of object bounds.
+	class TouchScene {
+	  public:
+		TouchScene( const ci::Rectf &gridBounds = ci::Rectf( 0.0f, 0.0f, 2048.0f, 2048.0f ), float cellSize = 128.0f );
+		~TouchScene();
+		
+		//! Adds a TouchObject behind every object already in the scene
+		void	addObject( TouchObject *object );
+		void	removeObject( TouchObject *object );
+		//! Moves a TouchObject in front of every other object
+		void	bringToFront( TouchObject *object );
+		//! Moves a TouchObject behind every other object
+		void	sendToBack( TouchObject *object );
+		
+		//! Returns all TouchObjects, front to back
+		const std::vector<TouchObject*>&	getObjects() const;
+		int									numObjects() const { return mObjects.size(); }
+		//! Returns a key ordering the object among the others in the scene: lower is further in front. Changes when it's reordered.
+		int64_t								getDepth( const TouchObject *object ) const { return mEntries[object->mSceneLink.mIndex].mDepth; }
+		
+		//! Touches are dispatched front to back.  Captured touches are removed from the TouchList.
+		//! Moved, ended and cancelled touches go straight to the objects that accepted them in touchesBegan.
+		void	touchesBegan( TouchList *touches );
+		void	touchesMoved( TouchList *touches );
+		void	touchesEnded( TouchList *touches );
+		void	touchesCancelled( TouchList *touches );
+		
+		//! Updates all TouchObjects, back to front
+		void	update( float deltaTime = 0.01667f );
+		
+		//! Grid covering the interactive area.  Bounds outside of it are clamped to the edge cells.
+		void			setGrid( const ci::Rectf &gridBounds, float cellSize );
+		ci::Rectf		getGridBounds() const { return mGridBounds; }
+		float			getCellSize() const { return mCellSize; }
+		
+		//! Shares a touch sample history with every TouchObject in the scene, including ones added later
+		void				setTouchHistory( const TouchHistory *touchHistory );
+		const TouchHistory*	getTouchHistory() const { return mTouchHistory; }
+		//! Shares a time source with every TouchObject in the scene, including ones added later. NULL restores the default.
+		void				setTouchClock( const TouchClock *touchClock );
+		const TouchClock*	getTouchClock() const { return mTouchClock; }
+		
+		//! Groups touches into hands as they begin (see TouchClusterer), so TouchObjects can take the touches of one hand at a time
+		//! (see TouchObject::enableSingleCluster). linkDistance is measured in pixels, rejoinTime in seconds.
+		void					enableClustering( float linkDistance = 200.0f, float rejoinTime = 0.5f );
+		void					disableClustering();
+		bool					isClustering() const { return mIsClustering; }
+		const TouchClusterer&	getClusterer() const { return mClusterer; }
+		//! Returns the cluster of a touch, or -1 if it isn't down or clustering is disabled
+		int						getCluster( uint32_t touchId ) const { return mIsClustering ? mClusterer.getCluster( touchId ) : -1; }
+		
+		//! Returns the number of touches currently owned by TouchObjects
+		int		numRoutedTouches() const { return mRoutes.size(); }
+		
+		//! Called by TouchObject::markBoundsDirty()
+		void	markBoundsDirty( TouchObject *object );
+		
+	  protected:
+		struct Entry {
+			Entry() : mObject( NULL ), mGeneration( 0 ), mDepth( 0 ), mBounded( false ), mDirty( true ), mInCells( false ), mCellX1( 0 ), mCellY1( 0 ), mCellX2( -1 ), mCellY2( -1 ), mHitSlot( -1 ) {}
+			
+			TouchObject	*mObject;
+			//! Bumped each time the entry is freed, so a reused index can be told apart from its previous object
+			uint32_t	mGeneration;
+			//! Lower is further in front
+			int64_t		mDepth;
+			ci::Rectf	mBounds;
+			bool		mBounded, mDirty, mInCells;
+			int			mCellX1, mCellY1, mCellX2, mCellY2;
+			int			mHitSlot;
+		};
+		
+		struct EntryDepthCompare {
+			EntryDepthCompare( const std::vector<Entry> *entries ) : mEntries( entries ) {}
+			bool operator()( int a, int b ) const { return (*mEntries)[a].mDepth < (*mEntries)[b].mDepth; }
+			const std::vector<Entry> *mEntries;
+		};
+		
+		struct ObjectDepthCompare {
+			ObjectDepthCompare( const std::vector<Entry> *entries ) : mEntries( entries ) {}
+			bool operator()( const TouchObject *a, const TouchObject *b ) const { return (*mEntries)[a->mSceneLink.mIndex].mDepth < (*mEntries)[b->mSceneLink.mIndex].mDepth; }
+			const std::vector<Entry> *mEntries;
+		};
+		
+		//! Touches gathered for one TouchObject in touchesBegan
+		struct Hit {
+			int											mIndex;
+			uint32_t									mGeneration;
+			int64_t										mDepth;
+			TouchObject									*mObject;
+			std::vector<ci::app::TouchEvent::Touch>		mTouches;
+		};
+		
+		//! TouchObjects that accepted a touch in touchesBegan, front to back
+		static const int kMaxRouteOwners = 4;
+		struct Route {
+			Route() : mNumOwners( 0 ), mCaptured( false ), mBroadcast( false ) {}
+			
+			TouchObject		*mOwners[kMaxRouteOwners];
+			int				mNumOwners;
+			bool			mCaptured, mBroadcast;
+		};
+		typedef boost::unordered_map<uint32_t, Route>	RouteMap;
+		
+		typedef void (TouchObject::*TouchesFn)( const std::vector<ci::app::TouchEvent::Touch>& );
+		
+		struct HitDepthCompare {
+			HitDepthCompare( const std::vector<Hit> *hits ) : mHits( hits ) {}
+			bool operator()( int a, int b ) const { return (*mHits)[a].mDepth < (*mHits)[b].mDepth; }
+			const std::vector<Hit> *mHits;
+		};
+		
+		void	setDepth( int index, int64_t depth );
+		void	refreshBounds();
+		void	rebuildGrid();
+		void	updateCells( int index );
+		void	insertCells( int index );
+		void	removeCells( int index );
+		int		cellIndex( const ci::Vec2f &pos ) const;
+		void	cellRange( const ci::Rectf &bounds, int *x1, int *y1, int *x2, int *y2 ) const;
+		void	routeTouches( TouchList *touches, TouchesFn ownedTouchesFn, void (TouchObject::*touchesFn)( TouchList* ), bool releaseRoutes );
+		void	addHit( int index, const ci::app::TouchEvent::Touch &touch );
+		void	flushHits( TouchesFn touchesFn );
+		
+		// objects are sorted front to back lazily, entries keep their index for as long as their object is in the scene
+		mutable std::vector<TouchObject*>	mObjects;
+		mutable bool					mObjectsDirty;
+		std::vector<Entry>				mEntries;
+		std::vector<int>				mFreeIndices;
+		std::vector<int>				mDirtyIndices;
+		int64_t							mFrontDepth, mBackDepth;
+		bool							mGridDirty;
+		
+		// each cell lists object indices, sorted front to back
+		std::vector< std::vector<int> >	mCells;
+		std::vector<int>				mUnbounded;
+		ci::Rectf						mGridBounds;
+		float							mCellSize, mInvCellSize;
+		int								mNumCellsX, mNumCellsY;
+		
+		// touch id to owning objects, filled in touchesBegan
+		RouteMap						mRoutes;
+		TouchList						mBroadcastTouches;
+		
+		// touches gathered per object for one dispatch, reused between events
+		std::vector<Hit>				mHits;
+		std::vector<int>				mHitOrder;
+		int								mNumHits;
+		
+		TouchClusterer					mClusterer;
+		bool							mIsClustering;
+		
+		const TouchHistory				*mTouchHistory;
+		const TouchClock				*mTouchClock;
+	};
+	
+}
@@ -31,6 +31,7 @@
 #include "cinder/Vector.h"
 #include <list>
 
+#include "OneEuroFilter.h"
 #include "TouchObject.h"
 #include "TouchPivot.h"
 
@@ -42,6 +43,7 @@ namespace Pivot {
 		Trackball( ci::Vec2f center, float radius, bool captureTouches = true );
 		
 		bool	hitTest( ci::app::TouchEvent::Touch touch );
+		bool	getBounds( ci::Rectf *bounds );
 		
 		void	pivotBegan( TouchPivot *touchPivot );
 		void	pivotMoved( TouchPivot *touchPivot );
@@ -49,13 +51,26 @@ namespace Pivot {
 		void	pivotEnded( TouchPivot *touchPivot );
 		void	pivotCancelled( TouchPivot *touchPivot );
 		
-		void	update( float deltaTime );
+		//! Also advances the orientation filter, if enabled
+		void	update( float deltaTime = 0.01667f );
 		
+		//! Blended between the last two steps when a fixed timestep is enabled (see TouchObject::enableFixedTimestep()), then filtered if enabled
 		ci::Quatf	getOrientation();
 		ci::Vec2f	getCenter() { return mCenter; }
-		float		getRadius() { return mRadius; }
+		float		getRadius() { return isFixedTimestep() ? ci::lerp( mPrevStepRadius, mRadius, mStepAlpha ) : mRadius; }
 		void		reset();
 		
+		//! Orientation the current momentum reaches after time seconds, or where it comes to rest. O(1), without changing the trackball.
+		ci::Quatf	getOrientationAt( float time );
+		ci::Quatf	getRestOrientation();
+		//! Returns the time until the current momentum comes to rest, in seconds. 0 if at rest.
+		float		getSettleTime();
+		
+		
+		//! Smooths getOrientation() with a OneEuroFilter, timed by update()'s delta times. \a beta is per radian per second of spin.
+		void		enableOrientationFilter( float minCutoff = 1.0f, float beta = 5.0f, float derivativeCutoff = 1.0f );
+		void		disableOrientationFilter() { mIsOrientationFiltered = false; }
+		bool		isOrientationFiltered() const { return mIsOrientationFiltered; }
 		
 		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
 		
@@ -98,6 +113,13 @@ namespace Pivot {
 				mCurrentQuat.normalize();
 			}
 			
+			//! Turns about the axis of \a angle by its length, in radians. Turns about one axis add up, so a coast split into
+			//! steps lands where a single step would.
+			void coast( const ci::Vec3f &angle ) {
+				float length = angle.length();
+				if ( length > 0.0f ) multQuat( ci::Quatf( angle / length, length ) );
+			}
+			
 			void		resetQuat() { mCurrentQuat = mInitialPosQuat = ci::Quatf( ci::Vec3f::yAxis(), 0 ); }
 			
 			ci::Quatf	getQuat() const { return mCurrentQuat; }
@@ -133,12 +155,32 @@ namespace Pivot {
 		
 		ci::Vec2f				mCenter;
 		
-		ci::Quatf				mRotQuat, mOffsetQuat, mPrevOrientation;
+		ci::Quatf				mPrevOrientation;
 		Trackball::Arcball		mBaseArcball;
 		
 		ci::Vec3f				mBaseAxisDirection, mPrevBaseAxis, mOrientationVel;
 		
 		float					mMinRadius, mMaxRadius, mPullResistance, mReleaseRetraction;
+		
+		ci::Quatf				mPrevStepOrientation;
+		float					mPrevStepRadius;
+		
+		OneEuroFilter<ci::Quatf>	mOrientationFilter;
+		bool					mIsOrientationFiltered;
+		double					mFilterTime;
+		
+		//! Orientation of the simulated pose, never blended
+		ci::Quatf				calcOrientation() const { return calcOrientation( mBaseArcball, mRot ); }
+		ci::Quatf				calcOrientation( const Trackball::Arcball &arcball, float rot ) const;
+		//! Orientation blended between steps, never filtered
+		ci::Quatf				calcBlendedOrientation();
+		void					integrate( float deltaTime );
+		//! Applies range limits and puts the trackball to rest once motion is unnoticable. Ends every momentum step.
+		void					endStep( float deltaTime );
+		ci::Quatf				calcCoastOrientation( float travel );
+		void					storePrevPose();
+		
+		friend class MomentumBatch;
 	};
 	
 }
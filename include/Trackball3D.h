@@ -33,6 +33,7 @@
 #include "cinder/Vector.h"
 #include <list>
 
+#include "OneEuroFilter.h"
 #include "TouchObject.h"
 #include "TouchPivot.h"
 
@@ -41,9 +42,12 @@ namespace Pivot {
 	class Trackball3D : public TouchObject3D {
 	public:
 		Trackball3D() {}
-		Trackball3D( ci::Vec3f center, float radius, ci::CameraPersp cam, bool captureTouches = true );
+		Trackball3D( ci::Vec3f center, float radius, const ci::CameraPersp &cam, bool captureTouches = true );
+		//! For use without a window, e.g. headless tests
+		Trackball3D( ci::Vec3f center, float radius, const ci::CameraPersp &cam, const ci::Vec2f &viewSize, bool captureTouches = true );
 		
 		bool	hitTest( ci::app::TouchEvent::Touch touch );
+		bool	getBounds( ci::Rectf *bounds );
 		
 		void	pivotBegan( TouchPivot *touchPivot );
 		void	pivotMoved( TouchPivot *touchPivot );
@@ -51,14 +55,27 @@ namespace Pivot {
 		void	pivotEnded( TouchPivot *touchPivot );
 		void	pivotCancelled( TouchPivot *touchPivot );
 		
-		void	update( float deltaTime );
+		//! Also advances the orientation filter, if enabled
+		void	update( float deltaTime = 0.01667f );
 		
+		//! Blended between the last two steps when a fixed timestep is enabled (see TouchObject::enableFixedTimestep()), then filtered if enabled
 		ci::Quatf		getOrientation();
 		ci::Vec3f		getCenter() { return mSphere.getCenter(); }
-		float			getRadius() { return mSphere.getRadius(); }
+		float			getRadius() { return isFixedTimestep() ? ci::lerp( mPrevStepRadius, mSphere.getRadius(), mStepAlpha ) : mSphere.getRadius(); }
 		ci::Sphere		getSphere() { return mSphere; }
 		void			reset();
 		
+		//! Orientation the current momentum reaches after time seconds, or where it comes to rest. O(1), without changing the trackball.
+		ci::Quatf		getOrientationAt( float time );
+		ci::Quatf		getRestOrientation();
+		//! Returns the time until the current momentum comes to rest, in seconds. 0 if at rest.
+		float			getSettleTime();
+		
+		//! Smooths getOrientation() with a OneEuroFilter, timed by update()'s delta times. \a beta is per radian per second of spin.
+		void		enableOrientationFilter( float minCutoff = 1.0f, float beta = 5.0f, float derivativeCutoff = 1.0f );
+		void		disableOrientationFilter() { mIsOrientationFiltered = false; }
+		bool		isOrientationFiltered() const { return mIsOrientationFiltered; }
+		
 		// BEHAVIORAL PARAMS //////////////////////////////////////////////////
 		
 		//! Minimum Trackball radius
@@ -80,15 +97,15 @@ namespace Pivot {
 		public:
 			Arcball3D() {}
 			
-			void setOrigin( const ci::Vec2f &pos, ci::Quatf currentQuat, ci::Sphere sphere, ci::CameraPersp cam, int viewWidth, int viewHeight )
+			void setOrigin( const ci::Vec2f &pos, ci::Quatf currentQuat, const ci::Sphere &sphere, const CameraSnapshot &projection )
 			{
 				mInitialPosQuat = mCurrentQuat = currentQuat;
-				mToAxis = mFromAxis = pointOnSphere( pos, sphere, cam, viewWidth, viewHeight );
+				mToAxis = mFromAxis = pointOnSphere( pos, sphere, projection );
 			}
 			
-			void move( const ci::Vec2f &pos, ci::Sphere sphere, ci::CameraPersp cam, int viewWidth, int viewHeight )
+			void move( const ci::Vec2f &pos, const ci::Sphere &sphere, const CameraSnapshot &projection )
 			{
-				mToAxis = pointOnSphere( pos, sphere, cam, viewWidth, viewHeight );
+				mToAxis = pointOnSphere( pos, sphere, projection );
 				ci::Vec3f axis = mFromAxis.cross( mToAxis );
 				mCurrentQuat = mInitialPosQuat * ci::Quatf( mFromAxis.dot( mToAxis ), axis.x, axis.y, axis.z );
 				mCurrentQuat.normalize();
@@ -99,6 +116,13 @@ namespace Pivot {
 				mCurrentQuat.normalize();
 			}
 			
+			//! Turns about the axis of \a angle by its length, in radians. Turns about one axis add up, so a coast split into
+			//! steps lands where a single step would.
+			void coast( const ci::Vec3f &angle ) {
+				float length = angle.length();
+				if ( length > 0.0f ) multQuat( ci::Quatf( angle / length, length ) );
+			}
+			
 			void		resetQuat() { mCurrentQuat = mInitialPosQuat = ci::Quatf( ci::Vec3f::yAxis(), 0 ); }
 			
 			ci::Quatf	getQuat() const { return mCurrentQuat; }
@@ -106,10 +130,8 @@ namespace Pivot {
 			ci::Vec3f	getToAxis() const { return mToAxis; }
 			ci::Vec3f	getFromAxis() const { return mFromAxis; }
 			
-			static ci::Vec3f pointOnSphere( const ci::Vec2f &point, ci::Sphere sphere, ci::CameraPersp cam, int viewWidth, int viewHeight  ) {
-				float u = point.x / (float) viewWidth;
-				float v = point.y / (float) viewHeight;
-				ci::Ray ray = cam.generateRay(u , 1.0f - v, cam.getAspectRatio() );
+			static ci::Vec3f pointOnSphere( const ci::Vec2f &point, const ci::Sphere &sphere, const CameraSnapshot &projection ) {
+				ci::Ray ray = projection.generateRay( point );
 				ci::Sphere s = ci::Sphere( sphere.getCenter() - ci::Vec3f( 0.0f, 0.0f, sphere.getRadius() ), sphere.getRadius() * 2 );
 				
 				ci::Vec3f result;
@@ -118,7 +140,7 @@ namespace Pivot {
 				if ( s.intersect( ray, &intersection ) == 1 ) {
 					result = ray.calcPosition( intersection ) - s.getCenter();
 				} else {
-					ci::Vec2f center = cam.worldToScreen( sphere.getCenter(), float( viewWidth ), float( viewHeight ) );
+					ci::Vec2f center = projection.worldToScreen( sphere.getCenter() );
 					result.x = ( point.x - center.x ) / ( sphere.getRadius() * 2 );
 					result.y = ( center.y - point.y ) / ( sphere.getRadius() * 2 );
 					result.z = 0.0f;
@@ -140,12 +162,35 @@ namespace Pivot {
 		
 		ci::Sphere				mSphere;
 		
-		ci::Quatf				mRotQuat, mOffsetQuat, mPrevOrientation;
+		ci::Quatf				mPrevOrientation;
 		Trackball3D::Arcball3D	mBaseArcball, mPosVelArcball;
 		
 		ci::Vec3f				mBaseAxisDirection, mPrevBaseAxis, mOrientationVel;
 		
 		float					mMinRadius, mMaxRadius, mPullResistance, mReleaseRetraction;
+		
+		ci::Quatf				mPrevStepOrientation;
+		float					mPrevStepRadius;
+		
+		OneEuroFilter<ci::Quatf>	mOrientationFilter;
+		bool					mIsOrientationFiltered;
+		double					mFilterTime;
+		
+		//! Orientation of the simulated pose, never blended
+		ci::Quatf				calcOrientation() const { return calcOrientation( mBaseArcball, mRot ); }
+		ci::Quatf				calcOrientation( const Trackball3D::Arcball3D &arcball, float rot ) const;
+		//! Orientation blended between steps, never filtered
+		ci::Quatf				calcBlendedOrientation();
+		void					integrate( float deltaTime );
+		//! Applies range limits and puts the trackball to rest once motion is unnoticable. Ends every momentum step.
+		void					endStep( float deltaTime );
+		ci::Quatf				calcCoastOrientation( float travel );
+		void					storePrevPose();
+		
+		friend class MomentumBatch;
+		
+	  private:
+		void					init( ci::Vec3f center, float radius );
 	};
 	
 }
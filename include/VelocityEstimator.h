@@ -0,0 +1,81 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#pragma once
+
+namespace Pivot {
+	
+	//! Estimates how fast one value changes from timestamped samples, for release velocities. O(1) amortized per sample
+	//! and stored inline. Uses the samples' own timestamps, so estimates don't depend on the digitizer's event rate.
+	class VelocityEstimator {
+	  public:
+		enum Mode {
+			//! Slope of a least-squares line fit to the samples within the window
+			LEAST_SQUARES,
+			//! Constant-velocity Kalman filter over all samples
+			KALMAN
+		};
+		
+		static const int kCapacity = 32;
+		
+		VelocityEstimator( Mode mode = LEAST_SQUARES, double window = 0.06 );
+		
+		void	setMode( Mode mode ) { mMode = mode; reset(); }
+		Mode	getMode() const { return mMode; }
+		//! Seconds of samples fit in LEAST_SQUARES mode. In both modes, a gap this long between samples restarts the estimate.
+		void	setWindow( double window ) { mWindow = window; }
+		double	getWindow() const { return mWindow; }
+		//! Variance of acceleration per second, and of each sample. Only their ratio matters, so one setting fits pixels and radians alike.
+		void	setKalmanNoise( double processNoise, double measurementNoise ) { mProcessNoise = processNoise; mMeasurementNoise = measurementNoise; }
+		
+		void	reset();
+		void	addSample( double time, double value );
+		int		numSamples() const { return mNumSamples; }
+		
+		//! Returns the estimated rate of change per second, or 0 with fewer than two samples
+		double	getVelocity() const;
+		
+	  private:
+		void	removeOldest();
+		
+		Mode	mMode;
+		double	mWindow, mProcessNoise, mMeasurementNoise;
+		
+		// samples relative to the first one since reset, for precision
+		double	mBaseTime, mBaseValue, mLastTime;
+		int		mNumSamples;
+		
+		// LEAST_SQUARES: ring of samples in the window, and their running sums
+		double	mTimes[kCapacity], mValues[kCapacity];
+		int		mHead, mSize;
+		double	mSumT, mSumV, mSumTT, mSumTV;
+		
+		// KALMAN: position, velocity and their covariance
+		double	mPos, mVel, mCovPP, mCovPV, mCovVV;
+	};
+	
+}
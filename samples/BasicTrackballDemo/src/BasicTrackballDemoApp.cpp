@@ -16,6 +16,7 @@
 #include "Card.h"
 #include "CatchAll.h"
 #include "TouchObject.h"
+#include "TouchScene.h"
 #include "PivotRenderer.h"
 
 using namespace ci;
@@ -43,7 +44,7 @@ public:
 	Pivot::Trackball		mTrackball3;
 	Pivot::CatchAll			mCatchAll; // for debug drawing leftover touches
 	
-	list<Pivot::TouchObject*>	mTouchObjects;
+	Pivot::TouchScene		mScene;
 	
 	float	mPrevTime;
 	
@@ -81,12 +82,17 @@ void BasicTrackballDemoApp::setup()
 	mTrackball2 = Pivot::Trackball3D( Vec3f( 200.0f, 800.0f, 0.0f ), 200.0f, mCamPersp );
 	mTrackball3 = Pivot::Trackball( Vec2f( 570.0f, 800.0f ), 150.0f );
 	
-	// pushing these back in the order of interactive depth
-	mTouchObjects.push_back( &mCard );
-	mTouchObjects.push_back( &mTrackball );
-	mTouchObjects.push_back( &mTrackball2 );
-	mTouchObjects.push_back( &mTrackball3 );
-	mTouchObjects.push_back( &mCatchAll );
+	// adding these in the order of interactive depth
+	mScene.setGrid( getWindowBounds(), 128.0f );
+	mScene.addObject( &mCard );
+	mScene.addObject( &mTrackball );
+	mScene.addObject( &mTrackball2 );
+	mScene.addObject( &mTrackball3 );
+	mScene.addObject( &mCatchAll );
+	
+	// one touchesMoved per frame, with every raw sample kept for release velocities
+	enableTouchCoalescing();
+	mScene.setTouchHistory( &getTouchHistory() );
 	
 	mPrevTime = getElapsedSeconds();
 	
@@ -120,10 +126,7 @@ void BasicTrackballDemoApp::touchesBegan( TouchEvent event )
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
     
 	if ( mInteractObjects ) {
-		for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-			if ( touchesList.empty() ) break;
-			(*it)->touchesBegan( &touchesList );
-		}
+		mScene.touchesBegan( &touchesList );
 	} else {
 		mCatchAll.touchesBegan( &touchesList );
 	}
@@ -134,10 +137,7 @@ void BasicTrackballDemoApp::touchesMoved( TouchEvent event )
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
     
 	if ( mInteractObjects ) {
-		for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-			if ( touchesList.empty() ) break;
-			(*it)->touchesMoved( &touchesList );
-		}
+		mScene.touchesMoved( &touchesList );
 	} else {
 		mCatchAll.touchesMoved( &touchesList );
 	}
@@ -148,10 +148,7 @@ void BasicTrackballDemoApp::touchesEnded( TouchEvent event )
     Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
     
     if ( mInteractObjects ) {
-		for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-			if ( touchesList.empty() ) break;
-			(*it)->touchesEnded( &touchesList );
-		}
+		mScene.touchesEnded( &touchesList );
 	} else {
 		mCatchAll.touchesEnded( &touchesList );
 	}
@@ -162,10 +159,7 @@ void BasicTrackballDemoApp::touchesCancelled( TouchEvent event )
     Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
     
     if ( mInteractObjects ) {
-		for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-			if ( touchesList.empty() ) break;
-			(*it)->touchesCancelled( &touchesList );
-		}
+		mScene.touchesCancelled( &touchesList );
 	} else {
 		mCatchAll.touchesCancelled( &touchesList );
 	}
@@ -178,8 +172,7 @@ void BasicTrackballDemoApp::update()
 	float deltaTime = getElapsedSeconds() - mPrevTime;
 	mPrevTime = getElapsedSeconds();
 	
-	for( list<Pivot::TouchObject*>::reverse_iterator it = mTouchObjects.rbegin(); it != mTouchObjects.rend(); ++it )
-		(*it)->update( deltaTime );
+	mScene.update( deltaTime );
 }
 
 
@@ -196,7 +189,7 @@ void BasicTrackballDemoApp::draw()
 		Pivot::draw( mCard );
 	}
 	
-	for( list<Pivot::TouchObject*>::reverse_iterator it = mTouchObjects.rbegin(); it != mTouchObjects.rend(); ++it ) {
+	for( vector<Pivot::TouchObject*>::const_reverse_iterator it = mScene.getObjects().rbegin(); it != mScene.getObjects().rend(); ++it ) {
 		if ( mDrawTouches ) Pivot::drawTouches( *(*it) );
 		if ( mDrawPivot ) Pivot::drawPivot( *(*it) );
 	}
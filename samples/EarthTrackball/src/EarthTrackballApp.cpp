@@ -114,6 +114,8 @@ void EarthTrackballApp::setup()
 	
 	mTrackball = Pivot::Trackball3D( Vec3f( 0.0, 0.0, 0.0f ), mInitRadius, mPov.mCam );
 	mTrackball.setDebugColor( Color( 0,1,1 ) );
+	// smooths jitter at rest without lagging behind fast spins
+	mTrackball.enableOrientationFilter();
 	mSceneQuat = mTrackball.getOrientation();
 }
 
@@ -176,8 +178,8 @@ void EarthTrackballApp::update()
 	mEarth.setRadius( mTrackball.getRadius() );
 	mEarth.update();
     
-    // slerp scene orientation to Trackball orientation, for smoother movement
-	mSceneQuat = mSceneQuat.slerp( 0.4f, mTrackball.getOrientation() );
+    // apply Trackball orientation to scene
+	mSceneQuat = mTrackball.getOrientation();
 }
 
 
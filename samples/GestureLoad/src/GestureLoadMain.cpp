@@ -0,0 +1,169 @@
+/*
+ *  GestureLoadMain.cpp
+ *
+ *  Headless load test: plays synthetic gestures into a TouchScene of Cards, Trackballs and Trackball3Ds
+ *  and reports event throughput and per-event latency. No window or touch panel needed.
+ *
+ *  Build with vc10/GestureLoad.sln, or elsewhere as a console program together with the library sources
+ *  in ../../src, leaving out AppTouch.cpp and PivotRenderer.cpp, and link against Cinder.
+ *
+ *  Usage: GestureLoad [--seed N] [--rate HZ] [--cards N] [--trackballs N] [--trackballs3d N]
+ *                     [--gesture drag|pinch|rotate|flick|chaos|storm|random] [--repeat N] [--fingers N]
+ */
+
+#include "cinder/Camera.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Card.h"
+#include "GestureGenerator.h"
+#include "TouchScene.h"
+#include "Trackball.h"
+#include "Trackball3D.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+class GestureLoad {
+public:
+	GestureLoad() : mNumTouches( 0 ), mFrameTime( 1.0 / 60.0 ), mNextFrame( 0.0 ) {}
+	
+	void	dispatch( Pivot::TouchPhase phase, const TouchEvent &event );
+	void	report( double wallSeconds );
+	
+	Pivot::TouchScene		mScene;
+	ci::Timer				mTimer;
+	vector<double>			mLatencies;
+	size_t					mNumTouches;
+	double					mFrameTime, mNextFrame;
+};
+
+void GestureLoad::dispatch( Pivot::TouchPhase phase, const TouchEvent &event )
+{
+	// step momentum at 60 fps of gesture time, like an app's update()
+	double time = event.getTouches().front().getTime();
+	while( mNextFrame <= time ) {
+		mScene.update( float( mFrameTime ) );
+		mNextFrame += mFrameTime;
+	}
+	
+	Pivot::TouchList touches = Pivot::toList( event.getTouches() );
+	double start = mTimer.getSeconds();
+	switch( phase ) {
+		case Pivot::TOUCH_BEGAN: mScene.touchesBegan( &touches ); break;
+		case Pivot::TOUCH_MOVED: mScene.touchesMoved( &touches ); break;
+		case Pivot::TOUCH_ENDED: mScene.touchesEnded( &touches ); break;
+		case Pivot::TOUCH_CANCELLED: mScene.touchesCancelled( &touches ); break;
+	}
+	mLatencies.push_back( mTimer.getSeconds() - start );
+	mNumTouches += event.getTouches().size();
+}
+
+void GestureLoad::report( double wallSeconds )
+{
+	if ( mLatencies.empty() ) {
+		printf( "no events\n" );
+		return;
+	}
+	
+	double total = 0.0;
+	for( vector<double>::iterator it = mLatencies.begin(); it != mLatencies.end(); ++it )
+		total += *it;
+	sort( mLatencies.begin(), mLatencies.end() );
+	
+	size_t n = mLatencies.size();
+	printf( "events:        %lu (%lu touches)\n", (unsigned long)n, (unsigned long)mNumTouches );
+	printf( "events/sec:    %.0f dispatch only, %.0f including generation\n", n / total, n / wallSeconds );
+	printf( "latency (us):  p50 %.2f  p90 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+		   mLatencies[n * 50 / 100] * 1e6, mLatencies[n * 90 / 100] * 1e6, mLatencies[n * 99 / 100] * 1e6, mLatencies[n * 999 / 1000] * 1e6, mLatencies[n - 1] * 1e6 );
+}
+
+
+int main( int argc, char *argv[] )
+{
+	uint32_t seed = 1;
+	float rate = 240.0f;
+	int numCards = 200, numTrackballs = 20, numTrackballs3d = 10, repeat = 50, numFingers = 2;
+	string gesture = "random";
+	
+	for( int i = 1; i < argc; i += 2 ) {
+		string arg = argv[i];
+		if ( i + 1 == argc ) {
+			fprintf( stderr, "missing value for %s\n", arg.c_str() );
+			return 1;
+		}
+		const char *value = argv[i + 1];
+		if ( arg == "--seed" ) seed = strtoul( value, NULL, 10 );
+		else if ( arg == "--rate" ) rate = atof( value );
+		else if ( arg == "--cards" ) numCards = atoi( value );
+		else if ( arg == "--trackballs" ) numTrackballs = atoi( value );
+		else if ( arg == "--trackballs3d" ) numTrackballs3d = atoi( value );
+		else if ( arg == "--gesture" ) gesture = value;
+		else if ( arg == "--repeat" ) repeat = atoi( value );
+		else if ( arg == "--fingers" ) numFingers = atoi( value );
+		else {
+			fprintf( stderr, "unknown option %s\n", arg.c_str() );
+			return 1;
+		}
+	}
+	
+	const Vec2f viewSize( 1920.0f, 1080.0f );
+	const Rectf bounds( 0.0f, 0.0f, viewSize.x, viewSize.y );
+	Rand rand( seed );
+	
+	// objects live in vectors sized up front, so the scene's pointers stay valid
+	vector<Pivot::Card> cards;
+	vector<Pivot::Trackball> trackballs;
+	vector<Pivot::Trackball3D> trackballs3d;
+	cards.reserve( numCards );
+	trackballs.reserve( numTrackballs );
+	trackballs3d.reserve( numTrackballs3d );
+	
+	GestureLoad load;
+	load.mScene.setGrid( bounds, 128.0f );
+	
+	CameraPersp cam( viewSize.x, viewSize.y, 60.0f );
+	for( int i = 0; i < numTrackballs3d; ++i ) {
+		trackballs3d.push_back( Pivot::Trackball3D( Vec3f( rand.nextFloat( bounds.x1, bounds.x2 ), rand.nextFloat( bounds.y1, bounds.y2 ), 0.0f ), rand.nextFloat( 50.0f, 200.0f ), cam, viewSize ) );
+		load.mScene.addObject( &trackballs3d.back() );
+	}
+	for( int i = 0; i < numTrackballs; ++i ) {
+		trackballs.push_back( Pivot::Trackball( Vec2f( rand.nextFloat( bounds.x1, bounds.x2 ), rand.nextFloat( bounds.y1, bounds.y2 ) ), rand.nextFloat( 50.0f, 200.0f ) ) );
+		load.mScene.addObject( &trackballs.back() );
+	}
+	for( int i = 0; i < numCards; ++i ) {
+		cards.push_back( Pivot::Card( Vec2f( rand.nextFloat( bounds.x1, bounds.x2 ), rand.nextFloat( bounds.y1, bounds.y2 ) ), rand.nextFloat( 80.0f, 300.0f ), rand.nextFloat( 60.0f, 200.0f ), rand.nextFloat( -3.14f, 3.14f ) ) );
+		load.mScene.addObject( &cards.back() );
+	}
+	
+	Pivot::GestureGenerator generator( seed );
+	generator.setBounds( bounds );
+	generator.setRate( rate );
+	generator.setJitter( 0.5f );
+	generator.setTarget( std::bind( &GestureLoad::dispatch, &load, std::placeholders::_1, std::placeholders::_2 ) );
+	
+	load.mTimer.start();
+	for( int i = 0; i < repeat; ++i ) {
+		Vec2f center( rand.nextFloat( bounds.x1, bounds.x2 ), rand.nextFloat( bounds.y1, bounds.y2 ) );
+		if ( gesture == "drag" ) generator.drag( numFingers, center, Vec2f( rand.nextFloat( -400.0f, 400.0f ), rand.nextFloat( -400.0f, 400.0f ) ), 0.5f );
+		else if ( gesture == "pinch" ) generator.pinch( numFingers, center, 60.0f, rand.nextFloat( 20.0f, 240.0f ), 0.5f );
+		else if ( gesture == "rotate" ) generator.rotate( numFingers, center, 80.0f, rand.nextFloat( -3.0f, 3.0f ), 0.5f );
+		else if ( gesture == "flick" ) generator.flick( center, Vec2f( rand.nextFloat( -3000.0f, 3000.0f ), rand.nextFloat( -3000.0f, 3000.0f ) ), 0.1f );
+		else if ( gesture == "chaos" ) generator.chaos( 4, 2.0f );
+		else if ( gesture == "storm" ) generator.storm( 200, 1.0f );
+		else generator.randomGesture();
+	}
+	double wallSeconds = load.mTimer.getSeconds();
+	
+	printf( "seed %u, %.0f Hz, %d cards, %d trackballs, %d trackball3ds, %d x %s\n", seed, rate, numCards, numTrackballs, numTrackballs3d, repeat, gesture.c_str() );
+	load.report( wallSeconds );
+	return 0;
+}
@@ -18,6 +18,7 @@
 #include "Trackball.h"
 #include "Card.h"
 #include "CatchAll.h"
+#include "TouchScene.h"
 #include "PivotRenderer.h"
 
 #include "Resources.h"
@@ -55,7 +56,7 @@ public:
 	Pivot::Trackball		mTrackball;
 	Pivot::CatchAll	mCatchAll; // for debug drawing leftover touches
 	
-	list<Pivot::TouchObject*>	mTouchObjects;
+	Pivot::TouchScene		mScene;
 };
 
 
@@ -95,11 +96,14 @@ void ProductTrackballApp::setup()
 	// create UI
 	mTrackball = Pivot::Trackball( Vec2f( 640.0f, 400.0f ), 350.0f );
 	mTrackball.setDebugColor( Color( 0.3f, 0.3f, 0.3f ) );
+	// smooths jitter at rest without lagging behind fast spins
+	mTrackball.enableOrientationFilter();
 	mCatchAll.setDebugColor( Color( 0.8f, 0.8f, 0.8f ) );
 	
-	// pushing these back in the order of interactive depth
-	mTouchObjects.push_back( &mTrackball );
-	mTouchObjects.push_back( &mCatchAll );
+	// adding these in the order of interactive depth
+	mScene.setGrid( getWindowBounds(), 128.0f );
+	mScene.addObject( &mTrackball );
+	mScene.addObject( &mCatchAll );
 	
 	mSceneQuat = mTrackball.getOrientation();
 }
@@ -109,37 +113,25 @@ void ProductTrackballApp::setup()
 void ProductTrackballApp::touchesBegan( TouchEvent event )
 {
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
-	for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-		if ( touchesList.size() == 0 ) break;
-		(*it)->touchesBegan( &touchesList );
-	}
+	mScene.touchesBegan( &touchesList );
 }
 
 void ProductTrackballApp::touchesMoved( TouchEvent event )
 {
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
-	for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-		if ( touchesList.size() == 0 ) break;
-		(*it)->touchesMoved( &touchesList );
-	}
+	mScene.touchesMoved( &touchesList );
 }
 
 void ProductTrackballApp::touchesEnded( TouchEvent event )
 {
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
-	for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-		if ( touchesList.size() == 0 ) break;
-		(*it)->touchesEnded( &touchesList );
-	}
+	mScene.touchesEnded( &touchesList );
 }
 
 void ProductTrackballApp::touchesCancelled( TouchEvent event )
 {
 	Pivot::TouchList touchesList = Pivot::toList( event.getTouches() );
-	for( list<Pivot::TouchObject*>::iterator it = mTouchObjects.begin(); it != mTouchObjects.end(); ++it ) {
-		if ( touchesList.size() == 0 ) break;
-		(*it)->touchesCancelled( &touchesList );
-	}
+	mScene.touchesCancelled( &touchesList );
 }
 
 
@@ -149,8 +141,7 @@ void ProductTrackballApp::update()
 	float mDeltaTime = getElapsedSeconds() - mPrevTime;
 	mPrevTime = getElapsedSeconds();
 	
-	for( list<Pivot::TouchObject*>::reverse_iterator it = mTouchObjects.rbegin(); it != mTouchObjects.rend(); ++it )
-		(*it)->update( mDeltaTime );
+	mScene.update( mDeltaTime );
 }
 
 
@@ -184,7 +175,7 @@ void ProductTrackballApp::draw()
 	gl::scale( v );
 	
 	// apply Trackball orientation to scene
-	mSceneQuat = mSceneQuat.slerp( 0.4f, mTrackball.getOrientation() );
+	mSceneQuat = mTrackball.getOrientation();
 	gl::rotate( mSceneQuat );
     gl::rotate( Vec3f( 0.0f, 0.0f, 180.0f ) );
 	
@@ -206,7 +197,7 @@ void ProductTrackballApp::draw()
 	gl::disableDepthRead();
 	gl::disableDepthWrite();
 	//Pivot::draw( mTrackball );
-	for( list<Pivot::TouchObject*>::reverse_iterator it = mTouchObjects.rbegin(); it != mTouchObjects.rend(); ++it ) {
+	for( vector<Pivot::TouchObject*>::const_reverse_iterator it = mScene.getObjects().rbegin(); it != mScene.getObjects().rend(); ++it ) {
 		Pivot::drawTouches( *(*it) );
 		Pivot::drawPivot( *(*it) );
 	}
@@ -25,7 +25,11 @@
  be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
  */
 
+#include <algorithm>
+#include <functional>
+
 #include "AppTouch.h"
+#include "TouchPlayer.h"
 
 namespace Pivot {
     
@@ -36,7 +40,8 @@ namespace Pivot {
     
     
     AppTouch::AppTouch()
-    : AppNative()
+    : AppNative(), mCoalescingTouches( false ), mPredictingTouches( false ), mPredictionLatency( 0.0 ), mPredictionHorizon( 0.0 ),
+      mQueueingTouches( false ), mDrainingTouches( false ), mRejectingPalms( false ), mTouchRecorder( NULL )
     {
         const Settings s = getSettings();
         console() << s.isMultiTouchEnabled() << endl;
@@ -48,28 +53,176 @@ namespace Pivot {
         registerMouseDown( this, &AppTouch::preMouseDown );
         registerMouseDrag( this, &AppTouch::preMouseDrag );
         registerMouseUp( this, &AppTouch::preMouseUp );
+        
+        // queued touches and coalesced moves are delivered right before update()
+        getSignalUpdate().connect( std::bind( &AppTouch::preUpdate, this ) );
+    }
+    
+    
+    
+    void AppTouch::enableTouchCoalescing( bool coalesceTouches )
+    {
+        if ( ! coalesceTouches ) flushTouches();
+        mCoalescingTouches = coalesceTouches;
+        if ( ! mCoalescingTouches ) {
+            mTouchHistory.clear();
+            disableTouchPrediction();
+        }
+    }
+    
+    void AppTouch::enableTouchPrediction( double latency, double maxHorizon )
+    {
+        enableTouchCoalescing();
+        mPredictingTouches = true;
+        mPredictionLatency = latency;
+        mPredictionHorizon = math<double>::abs( maxHorizon );
+    }
+    
+    void AppTouch::disableTouchPrediction()
+    {
+        mPredictingTouches = false;
+        mPredictedTouches.clear();
+    }
+    
+    void AppTouch::enableTouchQueue( bool queueTouches )
+    {
+        if ( ! queueTouches ) drainTouchInput( &mTouchQueue );
+        mQueueingTouches = queueTouches;
+    }
+    
+    void AppTouch::enablePalmRejection( bool rejectPalms )
+    {
+        mRejectingPalms = rejectPalms;
+        mPalmRejector.clear();
+    }
+    
+    void AppTouch::addTouchInput( TouchInputQueue *input )
+    {
+        if ( find( mTouchInputs.begin(), mTouchInputs.end(), input ) == mTouchInputs.end() ) mTouchInputs.push_back( input );
+    }
+    
+    void AppTouch::removeTouchInput( TouchInputQueue *input )
+    {
+        mTouchInputs.erase( remove( mTouchInputs.begin(), mTouchInputs.end(), input ), mTouchInputs.end() );
+    }
+    
+    
+    
+    void AppTouch::dispatchTouches( TouchPhase phase, const TouchEvent &event )
+    {
+        if ( ! mRejectingPalms ) {
+            deliverTouches( phase, event );
+            return;
+        }
+        
+        vector<TouchEvent::Touch> touches = event.getTouches();
+        switch( phase ) {
+            case TOUCH_BEGAN: {
+                vector<TouchEvent::Touch> cancelledTouches;
+                mPalmRejector.touchesBegan( &touches, &cancelledTouches );
+                if ( ! cancelledTouches.empty() ) cancelPalmTouches( cancelledTouches );
+                break;
+            }
+            case TOUCH_MOVED:
+                mPalmRejector.touchesMoved( &touches );
+                break;
+            case TOUCH_ENDED:
+            case TOUCH_CANCELLED:
+                mPalmRejector.touchesEnded( &touches );
+                break;
+        }
+        if ( ! touches.empty() ) deliverTouches( phase, TouchEvent( touches ) );
+    }
+    
+    void AppTouch::deliverTouches( TouchPhase phase, const TouchEvent &event )
+    {
+        const vector<TouchEvent::Touch> &touches = event.getTouches();
+        
+        switch( phase ) {
+            case TOUCH_BEGAN: {
+                flushTouches();
+                vector<TouchEvent::Touch> emptyTouchVector;
+                if ( ! mDrainingTouches ) cancelStaleTouches( emptyTouchVector );
+                if ( mTouchRecorder ) mTouchRecorder->record( phase, touches );
+                recordTouches( touches );
+                touchesBegan( event );
+                break;
+            }
+            case TOUCH_MOVED:
+                if ( mTouchRecorder ) mTouchRecorder->record( phase, touches );
+                if ( mCoalescingTouches ) queueTouchesMoved( touches );
+                else touchesMoved( event );
+                break;
+            case TOUCH_ENDED:
+                flushTouches();
+                if ( ! mDrainingTouches ) cancelStaleTouches( touches );
+                if ( mTouchRecorder ) mTouchRecorder->record( phase, touches );
+                recordTouches( touches );
+                touchesEnded( event );
+                forgetTouches( touches );
+                break;
+            case TOUCH_CANCELLED:
+                flushTouches();
+                if ( mTouchRecorder ) mTouchRecorder->record( phase, touches );
+                touchesCancelled( event );
+                forgetTouches( touches );
+                break;
+        }
+    }
+    
+    void AppTouch::receiveTouches( TouchPhase phase, const vector<TouchEvent::Touch> &touches )
+    {
+        // the platform's native touch data doesn't outlive the event
+        if ( mRejectingPalms && phase == TOUCH_BEGAN ) mPalmRejector.readContactSizes( touches );
+        if ( mQueueingTouches ) {
+            // the platform's active touches only match the stream as events arrive, so stale touches are found now and queued ahead of the event
+            if ( phase == TOUCH_BEGAN || phase == TOUCH_ENDED ) {
+                vector<TouchEvent::Touch> staleTouches = findStaleTouches( phase == TOUCH_ENDED ? touches : vector<TouchEvent::Touch>() );
+                if ( ! staleTouches.empty() ) mTouchQueue.push( TOUCH_CANCELLED, staleTouches );
+            }
+            mTouchQueue.push( phase, touches );
+        } else {
+            dispatchTouches( phase, TouchEvent( touches ) );
+        }
+    }
+    
+    void AppTouch::preUpdate()
+    {
+        drainTouchInput( &mTouchQueue );
+        for( vector<TouchInputQueue*>::iterator it = mTouchInputs.begin(); it != mTouchInputs.end(); ++it )
+            drainTouchInput( *it );
+        if ( mPredictingTouches ) predictTouches();
+        flushTouches();
+    }
+    
+    void AppTouch::drainTouchInput( TouchInputQueue *input )
+    {
+        // drained events are behind the platform's active touches, so they skip stale detection
+        bool wasDraining = mDrainingTouches;
+        mDrainingTouches = true;
+        TouchPhase phase;
+        while( input->pop( &phase, &mDrainedTouches ) )
+            dispatchTouches( phase, TouchEvent( mDrainedTouches ) );
+        mDrainingTouches = wasDraining;
     }
     
     
     
     bool AppTouch::preTouchesBegan ( TouchEvent event )
     {
-        vector<TouchEvent::Touch> emptyTouchVector;
-        cancelStaleTouches( emptyTouchVector );
-        touchesBegan( event );
+        receiveTouches( TOUCH_BEGAN, event.getTouches() );
         return true;
     }
     
     bool AppTouch::preTouchesMoved ( TouchEvent event )
     {
-        touchesMoved( event );
+        receiveTouches( TOUCH_MOVED, event.getTouches() );
         return true;
     }
     
     bool AppTouch::preTouchesEnded ( TouchEvent event )
     {
-        cancelStaleTouches( event.getTouches() );
-        touchesEnded( event );
+        receiveTouches( TOUCH_ENDED, event.getTouches() );
         return true;
     }
     
@@ -79,32 +232,170 @@ namespace Pivot {
     {
         mMouseDownTimeStamp = getElapsedSeconds();
         mPrevMousePos = event.getPos();
-        touchesBegan( TouchEvent( vector<TouchEvent::Touch>( 1, TouchEvent::Touch( mPrevMousePos, mPrevMousePos, 0, 0.0, NULL ) ) ) );
+        receiveTouches( TOUCH_BEGAN, vector<TouchEvent::Touch>( 1, TouchEvent::Touch( mPrevMousePos, mPrevMousePos, 0, mMouseDownTimeStamp, NULL ) ) );
         return false;
     }
     
     bool AppTouch::preMouseDrag( MouseEvent event )
     {
-        touchesMoved( TouchEvent( vector<TouchEvent::Touch>( 1, TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, mMouseDownTimeStamp - getElapsedSeconds(), NULL ) ) ) );
+        receiveTouches( TOUCH_MOVED, vector<TouchEvent::Touch>( 1, TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, getElapsedSeconds(), NULL ) ) );
         mPrevMousePos = Vec2f( event.getPos() );
         return false;
     }
     
     bool AppTouch::preMouseUp( MouseEvent event )
     {
-        touchesEnded( TouchEvent( vector<TouchEvent::Touch>( 1, TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, mMouseDownTimeStamp - getElapsedSeconds(), NULL ) ) ) );
+        receiveTouches( TOUCH_ENDED, vector<TouchEvent::Touch>( 1, TouchEvent::Touch( event.getPos(), mPrevMousePos, 0, getElapsedSeconds(), NULL ) ) );
         return false;
     }
     
     
     
+    void AppTouch::queueTouchesMoved( const vector<TouchEvent::Touch>& touches )
+    {
+        recordTouches( touches );
+        
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt ) {
+            vector<TouchEvent::Touch>::iterator pendingIt = mPendingMoves.begin();
+            while( pendingIt != mPendingMoves.end() && pendingIt->getId() != touchIt->getId() ) ++pendingIt;
+            
+            // delivered after the platform event returns, when its native data is gone
+            if ( pendingIt == mPendingMoves.end() ) {
+                mPendingMoves.push_back( TouchEvent::Touch( touchIt->getPos(), touchIt->getPrevPos(), touchIt->getId(), touchIt->getTime(), NULL ) );
+            } else {
+                // latest position and time, but the previous position from before the first merged move
+                *pendingIt = TouchEvent::Touch( touchIt->getPos(), pendingIt->getPrevPos(), touchIt->getId(), touchIt->getTime(), NULL );
+            }
+        }
+    }
+    
+    void AppTouch::flushTouches()
+    {
+        if ( mPendingMoves.empty() ) return;
+        
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = mPendingMoves.begin(); touchIt != mPendingMoves.end(); ++touchIt ) {
+            for( vector<PredictedTouch>::iterator predictedIt = mPredictedTouches.begin(); predictedIt != mPredictedTouches.end(); ++predictedIt ) {
+                if ( predictedIt->mTouch.getId() == touchIt->getId() ) {
+                    predictedIt->mDeliveredPos = touchIt->getPos();
+                    break;
+                }
+            }
+        }
+        
+        TouchEvent event( mPendingMoves );
+        mPendingMoves.clear();
+        touchesMoved( event );
+    }
+    
+    void AppTouch::recordTouches( const vector<TouchEvent::Touch>& touches )
+    {
+        if ( ! mCoalescingTouches ) return;
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt )
+            mTouchHistory.addSample( *touchIt );
+        
+        if ( ! mPredictingTouches ) return;
+        double arrivalTime = getElapsedSeconds();
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt ) {
+            vector<PredictedTouch>::iterator predictedIt = mPredictedTouches.begin();
+            while( predictedIt != mPredictedTouches.end() && predictedIt->mTouch.getId() != touchIt->getId() ) ++predictedIt;
+            
+            if ( predictedIt == mPredictedTouches.end() ) {
+                PredictedTouch predicted;
+                predicted.mTouch = *touchIt;
+                predicted.mDeliveredPos = touchIt->getPos();
+                mPredictedTouches.push_back( predicted );
+                predictedIt = mPredictedTouches.end() - 1;
+            }
+            predictedIt->mTouch = *touchIt;
+            predictedIt->mArrivalTime = arrivalTime;
+        }
+    }
+    
+    void AppTouch::forgetTouches( const vector<TouchEvent::Touch>& touches )
+    {
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt ) {
+            mTouchHistory.removeTouch( touchIt->getId() );
+            for( vector<PredictedTouch>::iterator predictedIt = mPredictedTouches.begin(); predictedIt != mPredictedTouches.end(); ++predictedIt ) {
+                if ( predictedIt->mTouch.getId() == touchIt->getId() ) {
+                    mPredictedTouches.erase( predictedIt );
+                    break;
+                }
+            }
+        }
+    }
+    
+    void AppTouch::predictTouches()
+    {
+        // only fit the last few samples, so a finger that stops or turns isn't overshot for long
+        const double window = 0.05;
+        double now = getElapsedSeconds();
+        
+        for( vector<PredictedTouch>::iterator predictedIt = mPredictedTouches.begin(); predictedIt != mPredictedTouches.end(); ++predictedIt ) {
+            const TouchEvent::Touch &touch = predictedIt->mTouch;
+            double age = now - predictedIt->mArrivalTime;
+            
+            // a touch that hasn't moved for a while has stopped, so it is shown where it is
+            double offset = 0.0;
+            if ( age < window ) offset = math<double>::clamp( age + mPredictionLatency, -mPredictionHorizon, mPredictionHorizon );
+            Vec2f pos = ( offset != 0.0 ) ? mTouchHistory.resample( touch.getId(), offset, window ) : touch.getPos();
+            // stamped with the newest sample rather than the predicted time, which the next sample and a snap back would both be older than
+            double time = touch.getTime();
+            
+            vector<TouchEvent::Touch>::iterator pendingIt = mPendingMoves.begin();
+            while( pendingIt != mPendingMoves.end() && pendingIt->getId() != touch.getId() ) ++pendingIt;
+            
+            if ( pendingIt != mPendingMoves.end() )
+                *pendingIt = TouchEvent::Touch( pos, pendingIt->getPrevPos(), touch.getId(), time, NULL );
+            else if ( pos != predictedIt->mDeliveredPos )
+                mPendingMoves.push_back( TouchEvent::Touch( pos, predictedIt->mDeliveredPos, touch.getId(), time, NULL ) );
+        }
+    }
+    
+    
+    
+    
+    void AppTouch::cancelPalmTouches( const vector<TouchEvent::Touch>& touches )
+    {
+        // these are down but rejected now, so they must not come back as stale touches
+        for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt ) {
+            for( vector<TouchEvent::Touch>::iterator activeIt = mCurrentActiveTouches.begin(); activeIt != mCurrentActiveTouches.end(); ++activeIt ) {
+                if ( activeIt->getId() == touchIt->getId() ) {
+                    mCurrentActiveTouches.erase( activeIt );
+                    break;
+                }
+            }
+        }
+        
+        flushTouches();
+        if ( mTouchRecorder ) mTouchRecorder->record( TOUCH_CANCELLED, touches );
+        touchesCancelled( TouchEvent( touches ) );
+        forgetTouches( touches );
+    }
     
     void AppTouch::cancelStaleTouches( const vector<TouchEvent::Touch>& excludingTouches )
+    {
+        vector<TouchEvent::Touch> staleTouches = findStaleTouches( excludingTouches );
+        if ( ! staleTouches.empty() ) {
+            flushTouches();
+            if ( mTouchRecorder ) mTouchRecorder->record( TOUCH_CANCELLED, staleTouches );
+            touchesCancelled( TouchEvent( staleTouches ) );
+            forgetTouches( staleTouches );
+        }
+    }
+    
+    vector<TouchEvent::Touch> AppTouch::findStaleTouches( const vector<TouchEvent::Touch>& excludingTouches )
     {
         vector<TouchEvent::Touch> newActiveTouches = getActiveTouches();
+        if ( mRejectingPalms ) {
+            vector<TouchEvent::Touch>::iterator activeIt = newActiveTouches.begin();
+            while( activeIt != newActiveTouches.end() ) {
+                if ( mPalmRejector.isRejected( activeIt->getId() ) ) activeIt = newActiveTouches.erase( activeIt );
+                else ++activeIt;
+            }
+        }
         vector<TouchEvent::Touch> staleTouches = getStaleTouches( mCurrentActiveTouches, newActiveTouches, excludingTouches );
         mCurrentActiveTouches = newActiveTouches;
-        if ( ! staleTouches.empty() ) touchesCancelled( TouchEvent( staleTouches ) );
+        return staleTouches;
     }
     
     
@@ -135,6 +426,13 @@ namespace Pivot {
         return staleTouches;
     }
     
+    
+    // defined here rather than in TouchPlayer.cpp so headless programs can play recordings without linking AppTouch
+    void TouchPlayer::setTarget( AppTouch *app )
+    {
+        mTarget = std::bind( &AppTouch::dispatchTouches, app, std::placeholders::_1, std::placeholders::_2 );
+    }
+    
 }
 
 
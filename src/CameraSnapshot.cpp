@@ -0,0 +1,93 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "CameraSnapshot.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	static uint32_t sNextSnapshotVersion = 1;
+	
+	static bool equalMatrices( const Matrix44f &a, const Matrix44f &b )
+	{
+		for( int i = 0; i < 16; ++i )
+			if ( a.m[i] != b.m[i] ) return false;
+		return true;
+	}
+	
+	CameraSnapshot::CameraSnapshot()
+	: mViewSize( Vec2f::zero() ), mHalfViewSize( Vec2f::zero() ), mEyePoint( Vec3f::zero() ), mFov( 0.0f ), mNearClip( 0.0f ),
+	  mRayOrigin( Vec3f::zero() ), mRayStepX( Vec3f::zero() ), mRayStepY( Vec3f::zero() ), mEyeDepth( Vec3f::zero() ), mEyeDepthOffset( 0.0f ),
+	  mVersion( 0 )
+	{}
+	
+	CameraSnapshot::CameraSnapshot( const CameraPersp &cam, const Vec2f &viewSize )
+	: mViewSize( viewSize ), mHalfViewSize( viewSize / 2.0f ), mEyePoint( cam.getEyePoint() ), mFov( cam.getFov() ), mNearClip( cam.getNearClip() ),
+	  mVersion( sNextSnapshotVersion++ )
+	{
+		mModelView = cam.getModelViewMatrix();
+		mProjection = cam.getProjectionMatrix();
+		mViewProjection = mProjection * mModelView;
+		
+		// rays through the image plane are affine in screen space once scaled to unit depth along the view direction,
+		// so three rays from the camera are enough to map any pixel
+		Vec3f viewDirection = cam.getViewDirection();
+		float aspect = cam.getAspectRatio();
+		Vec3f d00 = cam.generateRay( 0.0f, 0.0f, aspect ).getDirection();
+		Vec3f d10 = cam.generateRay( 1.0f, 0.0f, aspect ).getDirection();
+		Vec3f d01 = cam.generateRay( 0.0f, 1.0f, aspect ).getDirection();
+		d00 /= d00.dot( viewDirection );
+		d10 /= d10.dot( viewDirection );
+		d01 /= d01.dot( viewDirection );
+		
+		// generateRay's v runs bottom to top, screen y runs top to bottom
+		mRayStepX = ( d10 - d00 ) / viewSize.x;
+		mRayStepY = ( d00 - d01 ) / viewSize.y;
+		mRayOrigin = d01;
+		
+		const float *m = mModelView.m;
+		mEyeDepth = Vec3f( m[2], m[6], m[10] );
+		mEyeDepthOffset = m[14];
+	}
+	
+	bool CameraSnapshot::matches( const CameraPersp &cam, const Vec2f &viewSize ) const
+	{
+		return mVersion != 0 && viewSize == mViewSize && equalMatrices( cam.getModelViewMatrix(), mModelView ) && equalMatrices( cam.getProjectionMatrix(), mProjection );
+	}
+	
+	Vec2f CameraSnapshot::worldToScreen( const Vec3f &worldPos ) const
+	{
+		const float *m = mViewProjection.m;
+		float x = m[0] * worldPos.x + m[4] * worldPos.y + m[8] * worldPos.z + m[12];
+		float y = m[1] * worldPos.x + m[5] * worldPos.y + m[9] * worldPos.z + m[13];
+		float w = m[3] * worldPos.x + m[7] * worldPos.y + m[11] * worldPos.z + m[15];
+		return Vec2f( ( x / w + 1.0f ) * mHalfViewSize.x, ( 1.0f - y / w ) * mHalfViewSize.y );
+	}
+	
+}
@@ -38,7 +38,7 @@ namespace Pivot {
 	using namespace std;
 	
 	Card::Card( Vec2f pos, float width, float height, float rotation, bool captureTouches )
-	: mPos( pos ), mWidth( width ), mHeight( height ), mRot( rotation ), TouchObject( captureTouches )
+	: mPos( pos ), mWidth( width ), mHeight( height ), mRot( rotation ), TouchObject( captureTouches ), mAxesDirty( true ), mTransformVersion( 0 )
 	{
 		mPivotPos = mPos;
 		mPivotOffset = Vec2f::zero();
@@ -62,13 +62,44 @@ namespace Pivot {
 
 	bool Card::hitTest( TouchEvent::Touch touch )
 	{
-		Vec2f v1 = Vec2f( mWidth*cosf( mRot ), mWidth*sinf( mRot ) );
-		Vec2f v2 = Vec2f( -mHeight*sinf( mRot ), mHeight*cosf( mRot ) );
+		Vec2f v1, v2;
+		getAxes( &v1, &v2 );
 		Vec2f v = touch.getPos() - mPos;
 		float vv1Dot = v.dot( v1 );
 		float vv2Dot = v.dot( v2 );
 		return vv1Dot >= 0.0f && vv1Dot <= v1.dot( v1 ) && vv2Dot >= 0.0f && vv2Dot <= v2.dot( v2 );
 	}
+	
+	bool Card::getBounds( Rectf *bounds )
+	{
+		Vec2f v1, v2;
+		getAxes( &v1, &v2 );
+		bounds->x1 = mPos.x + math<float>::min( 0.0f, v1.x ) + math<float>::min( 0.0f, v2.x );
+		bounds->y1 = mPos.y + math<float>::min( 0.0f, v1.y ) + math<float>::min( 0.0f, v2.y );
+		bounds->x2 = mPos.x + math<float>::max( 0.0f, v1.x ) + math<float>::max( 0.0f, v2.x );
+		bounds->y2 = mPos.y + math<float>::max( 0.0f, v1.y ) + math<float>::max( 0.0f, v2.y );
+		return true;
+	}
+	
+	void Card::getAxes( Vec2f *widthAxis, Vec2f *heightAxis )
+	{
+		if ( mAxesDirty ) {
+			float c = cosf( mRot );
+			float s = sinf( mRot );
+			mWidthAxis = Vec2f( mWidth*c, mWidth*s );
+			mHeightAxis = Vec2f( -mHeight*s, mHeight*c );
+			mAxesDirty = false;
+		}
+		*widthAxis = mWidthAxis;
+		*heightAxis = mHeightAxis;
+	}
+	
+	void Card::transformChanged()
+	{
+		mAxesDirty = true;
+		++mTransformVersion;
+		markBoundsDirty();
+	}
 
 
 	void Card::pivotBegan( TouchPivot *touchPivot )
@@ -100,6 +131,7 @@ namespace Pivot {
 		Vec2f v = mPivotOffset * mScale;
 		v = Vec2f( v.x*cosf( mRot ) - v.y*sinf( mRot ), v.x*sinf( mRot ) + v.y*cosf( mRot ) );
 		mPos = mPivotPos - v;
+		transformChanged();
 		mIsInMotion = true;
 	}
 
@@ -163,44 +195,145 @@ namespace Pivot {
 
 
 
-	void Card::update( float deltaTime )
+	void Card::storePrevPose()
+	{
+		mPrevStepPos = mPos;
+		mPrevStepRot = mRot;
+		mPrevStepScale = mScale;
+		mPrevStepWidth = mWidth;
+		mPrevStepHeight = mHeight;
+	}
+	
+	void Card::integrate( float deltaTime )
 	{
 		if ( mIsInMotion && mTouchPivot.numTouchPoints() < 2 ) {
 			
-			// velocity decay
-			float velDecay = math<float>::clamp( mVelDecay - ( mVelDecay * deltaTime ), 0.0f, 1.0f );
+			// exact for any deltaTime: advance by the distance the decaying velocities cover, then decay them
+			InertiaCurve inertia = getInertiaCurve();
+			float travel = inertia.getDistanceFactor( deltaTime );
+			mRot += mRotVel * travel;
+			mScale += mScaleVel * travel;
+			if ( mTouchPivot.numTouchPoints() < 1 )
+				mPivotPos += mPivotPosVel * travel;
+			
+			float velDecay = inertia.getVelocityFactor( deltaTime );
 			mPivotPosVel *= velDecay;
 			mRotVel *= velDecay;
 			mScaleVel *= velDecay;
 			
-			// rotation
-			mRot += mRotVel * deltaTime;
-			
-			// scale
-			mScale += mScaleVel * deltaTime;
-			mWidth = mOriginWidth * mScale;
-			mHeight = mOriginHeight * mScale;
-			
-			// pivot position
+			endStep( deltaTime );
+		}
+	}
+	
+	void Card::endStep( float deltaTime )
+	{
+		// limit scale
+		float prevScale = mScale;
+		mScale = limit( mScale, mReleaseRetraction, mMinScale, mMaxScale, deltaTime );
+		
+		// check if motion noticable
+		if ( mPivotPosVel.length() < 0.01f && math<float>::abs( mRotVel ) < 0.0001f && math<float>::abs( mScaleVel ) < 0.000001
+			&& math<float>::abs( mScale - prevScale ) < 0.001f ) {
+			// coast the remainder too, so the card lands exactly on getRestPos()
+			float rest = getInertiaCurve().getRestFactor();
+			mRot += mRotVel * rest;
+			mScale += mScaleVel * rest;
 			if ( mTouchPivot.numTouchPoints() < 1 )
-				mPivotPos += mPivotPosVel * deltaTime;
+				mPivotPos += mPivotPosVel * rest;
 			
-			// set postion based on rotation/scale/pivotpos
-			Vec2f v = mPivotOffset * mScale;
-			v = Vec2f( v.x*cosf( mRot ) - v.y*sinf( mRot ), v.x*sinf( mRot ) + v.y*cosf( mRot ) );
-			mPos = mPivotPos - v;
-			
-			// limit scale
-			float prevScale = mScale;
-			mScale = limit( mScale, mReleaseRetraction, mMinScale, mMaxScale, deltaTime );
-			
-			// check if motion noticable
-			if ( mPivotPosVel.length() < 0.01f && math<float>::abs( mRotVel ) < 0.0001f && math<float>::abs( mScaleVel ) < 0.000001
-				&& math<float>::abs( mScale - prevScale ) < 0.001f ) {
-				mPivotPosVel = Vec2f::zero();
-				mRotVel  = 0.0f;
-				mScaleVel = 0.0f;
-				mIsInMotion = false;
+			mPivotPosVel = Vec2f::zero();
+			mRotVel  = 0.0f;
+			mScaleVel = 0.0f;
+			mIsInMotion = false;
+		}
+		
+		// set postion based on rotation/scale/pivotpos
+		mWidth = mOriginWidth * mScale;
+		mHeight = mOriginHeight * mScale;
+		Vec2f v = mPivotOffset * mScale;
+		v = Vec2f( v.x*cosf( mRot ) - v.y*sinf( mRot ), v.x*sinf( mRot ) + v.y*cosf( mRot ) );
+		mPos = mPivotPos - v;
+		transformChanged();
+	}
+	
+	
+	Vec2f Card::getPosAt( float time )
+	{
+		Vec2f pos;
+		calcCoastPose( getInertiaCurve().getDistanceFactor( time ), &pos, NULL, NULL );
+		return pos;
+	}
+	
+	float Card::getRotAt( float time )
+	{
+		float rot;
+		calcCoastPose( getInertiaCurve().getDistanceFactor( time ), NULL, &rot, NULL );
+		return rot;
+	}
+	
+	float Card::getScaleAt( float time )
+	{
+		float scale;
+		calcCoastPose( getInertiaCurve().getDistanceFactor( time ), NULL, NULL, &scale );
+		return scale;
+	}
+	
+	Vec2f Card::getRestPos()
+	{
+		Vec2f pos;
+		calcCoastPose( getInertiaCurve().getRestFactor(), &pos, NULL, NULL );
+		return pos;
+	}
+	
+	float Card::getRestRot()
+	{
+		float rot;
+		calcCoastPose( getInertiaCurve().getRestFactor(), NULL, &rot, NULL );
+		return rot;
+	}
+	
+	float Card::getRestScale()
+	{
+		float scale;
+		calcCoastPose( getInertiaCurve().getRestFactor(), NULL, NULL, &scale );
+		return scale;
+	}
+	
+	float Card::getSettleTime()
+	{
+		fetchMomentum();
+		if ( ! mIsInMotion || mTouchPivot.numTouchPoints() > 1 ) return 0.0f;
+		
+		InertiaCurve inertia = getInertiaCurve();
+		float time = math<float>::max( inertia.getSettleTime( mRotVel, 0.0001f ), inertia.getSettleTime( mScaleVel, 0.000001f ) );
+		if ( mTouchPivot.numTouchPoints() < 1 )
+			time = math<float>::max( time, inertia.getSettleTime( mPivotPosVel.length(), 0.01f ) );
+		return time;
+	}
+	
+	void Card::calcCoastPose( float travel, Vec2f *pos, float *rot, float *scale )
+	{
+		fetchMomentum();
+		// same motion as integrate(), with range limits applied as a clamp
+		float coastRot = mRot;
+		float coastScale = mScale;
+		Vec2f coastPivotPos = mPivotPos;
+		if ( mIsInMotion && mTouchPivot.numTouchPoints() < 2 ) {
+			coastRot += mRotVel * travel;
+			coastScale = math<float>::clamp( mScale + mScaleVel * travel, mMinScale, mMaxScale );
+			if ( mTouchPivot.numTouchPoints() < 1 )
+				coastPivotPos += mPivotPosVel * travel;
+		}
+		
+		if ( rot ) *rot = coastRot;
+		if ( scale ) *scale = coastScale;
+		if ( pos ) {
+			if ( coastPivotPos == mPivotPos && coastRot == mRot && coastScale == mScale ) {
+				*pos = mPos;
+			} else {
+				Vec2f v = mPivotOffset * coastScale;
+				v = Vec2f( v.x*cosf( coastRot ) - v.y*sinf( coastRot ), v.x*sinf( coastRot ) + v.y*cosf( coastRot ) );
+				*pos = coastPivotPos - v;
 			}
 		}
 	}
@@ -0,0 +1,199 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <algorithm>
+
+#if defined( __AVX__ )
+	#include <immintrin.h>
+	#define PIVOT_CARDBATCH_AVX
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define PIVOT_CARDBATCH_SSE
+#endif
+
+#include "CardBatch.h"
+#include "TouchScene.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	CardBatch::CardBatch()
+	: mLayoutDirty( false ), mNumSlots( 0 )
+	{}
+	
+	void CardBatch::addCard( Card *card )
+	{
+		mCards.push_back( card );
+		mLayoutDirty = true;
+	}
+	
+	void CardBatch::removeCard( Card *card )
+	{
+		vector<Card*>::iterator it = find( mCards.begin(), mCards.end(), card );
+		if ( it == mCards.end() ) return;
+		mCards.erase( it );
+		mLayoutDirty = true;
+	}
+	
+	void CardBatch::clear()
+	{
+		mCards.clear();
+		mLayoutDirty = true;
+	}
+	
+	int CardBatch::hitTest( const Vec2f &pos )
+	{
+		refresh();
+		return hitTestSlots( pos.x, pos.y );
+	}
+	
+	void CardBatch::hitTest( const vector<TouchEvent::Touch> &touches, vector<int> *hits )
+	{
+		refresh();
+		hits->resize( touches.size() );
+		for( size_t i = 0; i < touches.size(); ++i ) {
+			Vec2f pos = touches[i].getPos();
+			(*hits)[i] = hitTestSlots( pos.x, pos.y );
+		}
+	}
+	
+	void CardBatch::hitTest( const Vec2f *points, int numPoints, int *hits )
+	{
+		refresh();
+		for( int i = 0; i < numPoints; ++i )
+			hits[i] = hitTestSlots( points[i].x, points[i].y );
+	}
+	
+	void CardBatch::refresh()
+	{
+		if ( mLayoutDirty ) {
+			int numCards = mCards.size();
+			mNumSlots = ( numCards + kLaneWidth - 1 ) / kLaneWidth * kLaneWidth;
+			
+			// padding slots get negative lengths, so they can never be hit
+			mPosX.assign( mNumSlots, 0.0f );
+			mPosY.assign( mNumSlots, 0.0f );
+			mWidthAxisX.assign( mNumSlots, 0.0f );
+			mWidthAxisY.assign( mNumSlots, 0.0f );
+			mHeightAxisX.assign( mNumSlots, 0.0f );
+			mHeightAxisY.assign( mNumSlots, 0.0f );
+			mWidthLenSq.assign( mNumSlots, -1.0f );
+			mHeightLenSq.assign( mNumSlots, -1.0f );
+			mVersions.resize( numCards );
+			mDepths.resize( numCards );
+			
+			for( int i = 0; i < numCards; ++i )
+				writeSlot( i );
+			mLayoutDirty = false;
+		} else {
+			for( size_t i = 0; i < mCards.size(); ++i )
+				if ( mCards[i]->getTransformVersion() != mVersions[i] ) writeSlot( i );
+		}
+		
+		// cards outside a scene sort behind every scene depth, in batch order
+		const int64_t unscenedDepth = int64_t( 1 ) << 62;
+		for( size_t i = 0; i < mCards.size(); ++i ) {
+			TouchScene *scene = mCards[i]->getScene();
+			mDepths[i] = scene ? scene->getDepth( mCards[i] ) : unscenedDepth + i;
+		}
+	}
+	
+	void CardBatch::writeSlot( int index )
+	{
+		Card *card = mCards[index];
+		Vec2f widthAxis, heightAxis;
+		card->getAxes( &widthAxis, &heightAxis );
+		// the simulated pose, not the blended one getPos() returns under a fixed timestep
+		Vec2f pos = card->mPos;
+		
+		mPosX[index] = pos.x;
+		mPosY[index] = pos.y;
+		mWidthAxisX[index] = widthAxis.x;
+		mWidthAxisY[index] = widthAxis.y;
+		mHeightAxisX[index] = heightAxis.x;
+		mHeightAxisY[index] = heightAxis.y;
+		mWidthLenSq[index] = widthAxis.dot( widthAxis );
+		mHeightLenSq[index] = heightAxis.dot( heightAxis );
+		mVersions[index] = card->getTransformVersion();
+	}
+	
+	int CardBatch::hitTestSlots( float x, float y ) const
+	{
+		// same test as Card::hitTest: the touch projects inside both edges. Hits are rare, so the depth compare stays scalar.
+		int hit = -1;
+#if defined( PIVOT_CARDBATCH_AVX )
+		__m256 px = _mm256_set1_ps( x );
+		__m256 py = _mm256_set1_ps( y );
+		__m256 zero = _mm256_setzero_ps();
+		for( int i = 0; i < mNumSlots; i += 8 ) {
+			__m256 vx = _mm256_sub_ps( px, _mm256_loadu_ps( &mPosX[i] ) );
+			__m256 vy = _mm256_sub_ps( py, _mm256_loadu_ps( &mPosY[i] ) );
+			__m256 d1 = _mm256_add_ps( _mm256_mul_ps( vx, _mm256_loadu_ps( &mWidthAxisX[i] ) ), _mm256_mul_ps( vy, _mm256_loadu_ps( &mWidthAxisY[i] ) ) );
+			__m256 d2 = _mm256_add_ps( _mm256_mul_ps( vx, _mm256_loadu_ps( &mHeightAxisX[i] ) ), _mm256_mul_ps( vy, _mm256_loadu_ps( &mHeightAxisY[i] ) ) );
+			__m256 in1 = _mm256_and_ps( _mm256_cmp_ps( d1, zero, _CMP_GE_OQ ), _mm256_cmp_ps( d1, _mm256_loadu_ps( &mWidthLenSq[i] ), _CMP_LE_OQ ) );
+			__m256 in2 = _mm256_and_ps( _mm256_cmp_ps( d2, zero, _CMP_GE_OQ ), _mm256_cmp_ps( d2, _mm256_loadu_ps( &mHeightLenSq[i] ), _CMP_LE_OQ ) );
+			int mask = _mm256_movemask_ps( _mm256_and_ps( in1, in2 ) );
+			if ( mask ) {
+				for( int lane = 0; lane < 8; ++lane )
+					if ( ( mask & ( 1 << lane ) ) && ( hit < 0 || mDepths[i + lane] < mDepths[hit] ) ) hit = i + lane;
+			}
+		}
+		return hit;
+#elif defined( PIVOT_CARDBATCH_SSE )
+		__m128 px = _mm_set1_ps( x );
+		__m128 py = _mm_set1_ps( y );
+		__m128 zero = _mm_setzero_ps();
+		for( int i = 0; i < mNumSlots; i += 4 ) {
+			__m128 vx = _mm_sub_ps( px, _mm_loadu_ps( &mPosX[i] ) );
+			__m128 vy = _mm_sub_ps( py, _mm_loadu_ps( &mPosY[i] ) );
+			__m128 d1 = _mm_add_ps( _mm_mul_ps( vx, _mm_loadu_ps( &mWidthAxisX[i] ) ), _mm_mul_ps( vy, _mm_loadu_ps( &mWidthAxisY[i] ) ) );
+			__m128 d2 = _mm_add_ps( _mm_mul_ps( vx, _mm_loadu_ps( &mHeightAxisX[i] ) ), _mm_mul_ps( vy, _mm_loadu_ps( &mHeightAxisY[i] ) ) );
+			__m128 in1 = _mm_and_ps( _mm_cmpge_ps( d1, zero ), _mm_cmple_ps( d1, _mm_loadu_ps( &mWidthLenSq[i] ) ) );
+			__m128 in2 = _mm_and_ps( _mm_cmpge_ps( d2, zero ), _mm_cmple_ps( d2, _mm_loadu_ps( &mHeightLenSq[i] ) ) );
+			int mask = _mm_movemask_ps( _mm_and_ps( in1, in2 ) );
+			if ( mask ) {
+				for( int lane = 0; lane < 4; ++lane )
+					if ( ( mask & ( 1 << lane ) ) && ( hit < 0 || mDepths[i + lane] < mDepths[hit] ) ) hit = i + lane;
+			}
+		}
+		return hit;
+#else
+		for( int i = 0; i < mNumSlots; ++i ) {
+			float vx = x - mPosX[i];
+			float vy = y - mPosY[i];
+			float d1 = vx * mWidthAxisX[i] + vy * mWidthAxisY[i];
+			float d2 = vx * mHeightAxisX[i] + vy * mHeightAxisY[i];
+			if ( d1 >= 0.0f && d1 <= mWidthLenSq[i] && d2 >= 0.0f && d2 <= mHeightLenSq[i] && ( hit < 0 || mDepths[i] < mDepths[hit] ) ) hit = i;
+		}
+		return hit;
+#endif
+	}
+	
+}
@@ -0,0 +1,242 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+#include <algorithm>
+#include <cfloat>
+
+#include "ChordClassifier.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	ChordClassifier::ChordClassifier()
+	: mIsScaleDirty( false ), mNumNeighbors( 3 ), mMaxDistance( FLT_MAX )
+	{
+		for( int f = 0; f < CHORD_NUM_FEATURES; ++f ) {
+			mWeights[f] = 1.0f;
+			mScales[f] = 1.0f;
+		}
+	}
+	
+	void ChordClassifier::calcFeatures( const TouchPointSpan &touchPoints, float *features )
+	{
+		fill( features, features + CHORD_NUM_FEATURES, 0.0f );
+		int count = math<int>::min( touchPoints.size(), kMaxTouches );
+		features[CHORD_COUNT] = float( count );
+		if ( count == 0 ) return;
+		
+		Vec2f pos[kMaxTouches], vel[kMaxTouches];
+		Vec2f centroid = Vec2f::zero(), meanVel = Vec2f::zero();
+		float meanSpeed = 0.0f;
+		for( int i = 0; i < count; ++i ) {
+			const TouchPoint &touchPoint = touchPoints[i];
+			double deltaTime = touchPoint.getTime() - touchPoint.getPrevTime();
+			pos[i] = touchPoint.getPos();
+			vel[i] = ( deltaTime > 0.0 ) ? touchPoint.getPosVel() : Vec2f::zero();
+			centroid += pos[i];
+			meanVel += vel[i];
+			meanSpeed += vel[i].length();
+		}
+		centroid /= float( count );
+		meanVel /= float( count );
+		meanSpeed /= count;
+		
+		features[CHORD_SPEED] = meanVel.length();
+		features[CHORD_COHERENCE] = ( meanSpeed > 1e-3f ) ? features[CHORD_SPEED] / meanSpeed : 1.0f;
+		features[CHORD_ANGULAR_GAP] = 1.0f;
+		if ( count == 1 ) return;
+		
+		// layout around the centroid, and each touch's motion relative to the centroid's
+		float radii[kMaxTouches], angles[kMaxTouches];
+		float spread = 0.0f, radialSpeed = 0.0f, tangentialSpeed = 0.0f;
+		float covXX = 0.0f, covYY = 0.0f, covXY = 0.0f;
+		for( int i = 0; i < count; ++i ) {
+			Vec2f offset = pos[i] - centroid;
+			radii[i] = offset.length();
+			angles[i] = math<float>::atan2( offset.y, offset.x );
+			spread += radii[i];
+			covXX += offset.x * offset.x;
+			covYY += offset.y * offset.y;
+			covXY += offset.x * offset.y;
+			
+			if ( radii[i] > 1e-3f ) {
+				Vec2f dir = offset / radii[i];
+				Vec2f relVel = vel[i] - meanVel;
+				radialSpeed += relVel.dot( dir );
+				tangentialSpeed += dir.x * relVel.y - dir.y * relVel.x;
+			}
+		}
+		spread /= count;
+		features[CHORD_SPREAD] = spread;
+		features[CHORD_RADIAL_SPEED] = radialSpeed / count;
+		features[CHORD_TANGENTIAL_SPEED] = tangentialSpeed / count;
+		
+		if ( spread > 1e-3f ) {
+			float variance = 0.0f;
+			for( int i = 0; i < count; ++i ) variance += ( radii[i] - spread ) * ( radii[i] - spread );
+			features[CHORD_RADIAL_VARIATION] = math<float>::sqrt( variance / count ) / spread;
+		}
+		
+		// a handful of angles, so insertion sort
+		for( int i = 1; i < count; ++i ) {
+			float angle = angles[i];
+			int j = i - 1;
+			for( ; j >= 0 && angles[j] > angle; --j ) angles[j + 1] = angles[j];
+			angles[j + 1] = angle;
+		}
+		float maxGap = angles[0] + 2.0f * M_PI - angles[count - 1];
+		for( int i = 1; i < count; ++i ) maxGap = math<float>::max( maxGap, angles[i] - angles[i - 1] );
+		features[CHORD_ANGULAR_GAP] = maxGap / ( 2.0f * M_PI );
+		
+		// ratio of the principal axes of the layout
+		float halfTrace = 0.5f * ( covXX + covYY );
+		float root = math<float>::sqrt( 0.25f * ( covXX - covYY ) * ( covXX - covYY ) + covXY * covXY );
+		float major = halfTrace + root, minor = math<float>::max( halfTrace - root, 0.0f );
+		if ( major > 1e-6f ) features[CHORD_ELONGATION] = 1.0f - math<float>::sqrt( minor / major );
+	}
+	
+	int ChordClassifier::addExample( const string &className, const float *features )
+	{
+		int label = find( mClassNames.begin(), mClassNames.end(), className ) - mClassNames.begin();
+		if ( label == int( mClassNames.size() ) ) mClassNames.push_back( className );
+		
+		mExamples.insert( mExamples.end(), features, features + CHORD_NUM_FEATURES );
+		mScaledExamples.resize( mExamples.size() );
+		mLabels.push_back( label );
+		mIsScaleDirty = true;
+		return label;
+	}
+	
+	int ChordClassifier::addExample( const string &className, const TouchPointSpan &touchPoints )
+	{
+		float features[CHORD_NUM_FEATURES];
+		calcFeatures( touchPoints, features );
+		return addExample( className, features );
+	}
+	
+	void ChordClassifier::clear()
+	{
+		mClassNames.clear();
+		mExamples.clear();
+		mScaledExamples.clear();
+		mLabels.clear();
+		mIsScaleDirty = false;
+	}
+	
+	void ChordClassifier::setNumNeighbors( int numNeighbors )
+	{
+		mNumNeighbors = math<int>::clamp( numNeighbors, 1, kMaxNeighbors );
+	}
+	
+	bool ChordClassifier::classify( const TouchPointSpan &touchPoints, Chord *chord )
+	{
+		calcFeatures( touchPoints, chord->mFeatures );
+		return classify( chord->mFeatures, chord );
+	}
+	
+	bool ChordClassifier::classify( const float *features, Chord *chord )
+	{
+		if ( features != chord->mFeatures ) copy( features, features + CHORD_NUM_FEATURES, chord->mFeatures );
+		chord->mClass = -1;
+		chord->mConfidence = 0.0f;
+		chord->mDistance = 0.0f;
+		if ( empty() ) return false;
+		if ( mIsScaleDirty ) updateScales();
+		
+		float scaled[CHORD_NUM_FEATURES];
+		for( int f = 0; f < CHORD_NUM_FEATURES; ++f ) scaled[f] = features[f] * mScales[f];
+		
+		// keep the k nearest, sorted, in fixed arrays
+		float nearestDistSq[kMaxNeighbors];
+		int nearestLabels[kMaxNeighbors];
+		int numNearest = 0;
+		int numExamples = mLabels.size();
+		for( int e = 0; e < numExamples; ++e ) {
+			const float *example = &mScaledExamples[e * CHORD_NUM_FEATURES];
+			float distSq = 0.0f;
+			for( int f = 0; f < CHORD_NUM_FEATURES; ++f ) distSq += ( scaled[f] - example[f] ) * ( scaled[f] - example[f] );
+			
+			if ( numNearest == mNumNeighbors && distSq >= nearestDistSq[numNearest - 1] ) continue;
+			int i = ( numNearest < mNumNeighbors ) ? numNearest++ : numNearest - 1;
+			for( ; i > 0 && nearestDistSq[i - 1] > distSq; --i ) {
+				nearestDistSq[i] = nearestDistSq[i - 1];
+				nearestLabels[i] = nearestLabels[i - 1];
+			}
+			nearestDistSq[i] = distSq;
+			nearestLabels[i] = mLabels[e];
+		}
+		
+		// neighbors vote by closeness, and the nearest example of the winner gives the distance
+		float votes[kMaxNeighbors], totalVotes = 0.0f;
+		for( int i = 0; i < numNearest; ++i ) {
+			votes[i] = 1.0f / ( math<float>::sqrt( nearestDistSq[i] ) + 1e-3f );
+			totalVotes += votes[i];
+		}
+		int winner = 0;
+		float winnerVotes = 0.0f;
+		for( int i = 0; i < numNearest; ++i ) {
+			float classVotes = 0.0f;
+			for( int j = 0; j < numNearest; ++j )
+				if ( nearestLabels[j] == nearestLabels[i] ) classVotes += votes[j];
+			if ( classVotes > winnerVotes ) {
+				winnerVotes = classVotes;
+				winner = i;
+			}
+		}
+		
+		chord->mDistance = math<float>::sqrt( nearestDistSq[winner] );
+		if ( chord->mDistance > mMaxDistance ) return false;
+		chord->mClass = nearestLabels[winner];
+		chord->mConfidence = winnerVotes / totalVotes;
+		return true;
+	}
+	
+	void ChordClassifier::updateScales()
+	{
+		// each feature is measured in deviations over the examples, so pixels and counts weigh alike
+		int numExamples = mLabels.size();
+		for( int f = 0; f < CHORD_NUM_FEATURES; ++f ) {
+			float mean = 0.0f;
+			for( int e = 0; e < numExamples; ++e ) mean += mExamples[e * CHORD_NUM_FEATURES + f];
+			mean /= numExamples;
+			float variance = 0.0f;
+			for( int e = 0; e < numExamples; ++e ) {
+				float delta = mExamples[e * CHORD_NUM_FEATURES + f] - mean;
+				variance += delta * delta;
+			}
+			float deviation = math<float>::sqrt( variance / numExamples );
+			mScales[f] = ( deviation > 1e-6f ) ? mWeights[f] / deviation : mWeights[f];
+		}
+		
+		for( size_t i = 0; i < mExamples.size(); ++i ) mScaledExamples[i] = mExamples[i] * mScales[i % CHORD_NUM_FEATURES];
+		mIsScaleDirty = false;
+	}
+	
+}
@@ -0,0 +1,204 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "GestureEngine.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	const double GestureEngine::kTimeBaseJump = 1.0;
+	
+	GestureEngine::GestureEngine()
+	: mPendingHead( 0 ), mNumTouches( 0 ), mPos( Vec2f::zero() ), mCentroid( Vec2f::zero() ), mHasCentroid( false ), mTime( 0.0 )
+	{
+		mPending.reserve( kPendingGesturesReserve );
+	}
+	
+	int GestureEngine::addRecognizer( const GestureRecognizer &recognizer )
+	{
+		mRecognizers.push_back( recognizer );
+		mRecognizers.back().reset();
+		mWaitingGestures.resize( mRecognizers.size() );
+		return mRecognizers.size() - 1;
+	}
+	
+	void GestureEngine::clear()
+	{
+		mRecognizers.clear();
+		mWaitingGestures.clear();
+		mPending.clear();
+		mPendingHead = 0;
+	}
+	
+	
+	void GestureEngine::touchesBegan( int numTouches, const Vec2f &centroid, double time )
+	{
+		// a fresh set of touches: start over every recognizer that has run its course
+		if ( mNumTouches == 0 ) {
+			for( vector<GestureRecognizer>::iterator it = mRecognizers.begin(); it != mRecognizers.end(); ++it )
+				if ( it->mState == GestureRecognizer::FAILED || it->mState == GestureRecognizer::RECOGNIZED ) it->reset();
+			mPos = centroid;
+		}
+		mNumTouches = numTouches;
+		mCentroid = centroid;
+		mHasCentroid = true;
+		time = advance( time );
+		
+		Gesture gesture;
+		for( size_t i = 0; i < mRecognizers.size(); ++i )
+			handle( i, mRecognizers[i].touchesBegan( numTouches, mPos, time, &gesture ), gesture );
+		resolve();
+	}
+	
+	void GestureEngine::touchesMoved( int numTouches, const Vec2f &centroid, double time )
+	{
+		if ( mHasCentroid && numTouches == mNumTouches ) mPos += centroid - mCentroid;
+		mNumTouches = numTouches;
+		mCentroid = centroid;
+		mHasCentroid = true;
+		time = advance( time );
+		
+		Gesture gesture;
+		for( size_t i = 0; i < mRecognizers.size(); ++i )
+			handle( i, mRecognizers[i].touchesMoved( numTouches, mPos, time, &gesture ), gesture );
+		resolve();
+	}
+	
+	void GestureEngine::touchesEnded( int numTouches, const Vec2f &centroid, double time )
+	{
+		// the centroid still includes the lifted touches, so it is comparable to the last one
+		if ( mHasCentroid ) mPos += centroid - mCentroid;
+		mNumTouches = numTouches;
+		mHasCentroid = false;
+		time = advance( time );
+		
+		Gesture gesture;
+		for( size_t i = 0; i < mRecognizers.size(); ++i )
+			handle( i, mRecognizers[i].touchesEnded( numTouches, mPos, time, &gesture ), gesture );
+		resolve();
+	}
+	
+	void GestureEngine::touchesCancelled( int numTouches, double time )
+	{
+		time = advance( time );
+		
+		Gesture gesture;
+		for( size_t i = 0; i < mRecognizers.size(); ++i ) {
+			GestureRecognizer &recognizer = mRecognizers[i];
+			if ( recognizer.mState == GestureRecognizer::ACTIVE && recognizer.report( GESTURE_CANCELLED, mPos, time, &gesture ) ) push( i, gesture );
+			recognizer.mState = GestureRecognizer::FAILED;
+			recognizer.mNumDown = numTouches;
+		}
+		mNumTouches = numTouches;
+		mHasCentroid = false;
+	}
+	
+	void GestureEngine::update( double time )
+	{
+		advance( time );
+		
+		Gesture gesture;
+		for( size_t i = 0; i < mRecognizers.size(); ++i )
+			handle( i, mRecognizers[i].update( mTime, &gesture ), gesture );
+		resolve();
+	}
+	
+	double GestureEngine::advance( double time )
+	{
+		// event stamps and the clock's estimate between them can disagree by a little latency, but a step back of
+		// more than that is a new time base, like a replay starting, and is followed
+		if ( time > mTime || time < mTime - kTimeBaseJump ) mTime = time;
+		return mTime;
+	}
+	
+	bool GestureEngine::popGesture( Gesture *gesture )
+	{
+		if ( mPendingHead == int( mPending.size() ) ) {
+			// keeps its capacity, so a drained queue is reused without allocating
+			mPending.clear();
+			mPendingHead = 0;
+			return false;
+		}
+		*gesture = mPending[mPendingHead++];
+		return true;
+	}
+	
+	
+	void GestureEngine::handle( int index, bool reported, const Gesture &gesture )
+	{
+		if ( ! reported ) return;
+		GestureRecognizer &recognizer = mRecognizers[index];
+		
+		bool isDiscrete = ( recognizer.mType == GESTURE_TAP || recognizer.mType == GESTURE_SWIPE );
+		if ( isDiscrete ) {
+			// wait for every earlier recognizer to fail first
+			for( int i = 0; i < index; ++i ) {
+				GestureRecognizer::State state = mRecognizers[i].mState;
+				if ( state == GestureRecognizer::POSSIBLE || state == GestureRecognizer::WAITING ) {
+					recognizer.mState = GestureRecognizer::WAITING;
+					mWaitingGestures[index] = gesture;
+					return;
+				}
+			}
+		}
+		
+		push( index, gesture );
+		if ( isDiscrete || gesture.mPhase == GESTURE_BEGAN ) failOthers( index );
+	}
+	
+	void GestureEngine::resolve()
+	{
+		for( size_t i = 0; i < mRecognizers.size(); ++i ) {
+			GestureRecognizer::State state = mRecognizers[i].mState;
+			if ( state == GestureRecognizer::POSSIBLE ) return;
+			if ( state == GestureRecognizer::WAITING ) {
+				mRecognizers[i].mState = GestureRecognizer::RECOGNIZED;
+				push( i, mWaitingGestures[i] );
+				failOthers( i );
+				return;
+			}
+		}
+	}
+	
+	void GestureEngine::failOthers( int index )
+	{
+		for( size_t i = 0; i < mRecognizers.size(); ++i ) {
+			GestureRecognizer::State state = mRecognizers[i].mState;
+			if ( int( i ) != index && ( state == GestureRecognizer::POSSIBLE || state == GestureRecognizer::WAITING ) ) mRecognizers[i].mState = GestureRecognizer::FAILED;
+		}
+	}
+	
+	void GestureEngine::push( int index, const Gesture &gesture )
+	{
+		// never dropped, or a lost GESTURE_ENDED would leave the client in a gesture for good
+		mPending.push_back( gesture );
+		mPending.back().mRecognizer = index;
+	}
+	
+}
@@ -0,0 +1,217 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#include "GestureGenerator.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	GestureGenerator::GestureGenerator( uint32_t seed )
+	: mRand( seed ), mBounds( 0.0f, 0.0f, 1024.0f, 768.0f ), mRate( 120.0f ), mJitter( 0.0f ), mTime( 0.0 ), mNextId( 1 )
+	{}
+	
+	void GestureGenerator::drag( int numFingers, const Vec2f &center, const Vec2f &offset, float duration )
+	{
+		for( int i = 0; i < numFingers; ++i ) {
+			Vec2f fingerOffset( mRand.nextFloat( -40.0f, 40.0f ), mRand.nextFloat( -40.0f, 40.0f ) );
+			addFinger( mTime, mTime + duration, center, fingerOffset, offset, 1.0f, 0.0f );
+		}
+		play();
+	}
+	
+	void GestureGenerator::pinch( int numFingers, const Vec2f &center, float fromRadius, float toRadius, float duration )
+	{
+		fromRadius = math<float>::max( fromRadius, 1.0f );
+		addCircle( mTime, mTime + duration, numFingers, center, fromRadius, Vec2f::zero(), toRadius / fromRadius, 0.0f );
+		play();
+	}
+	
+	void GestureGenerator::rotate( int numFingers, const Vec2f &center, float radius, float angle, float duration )
+	{
+		addCircle( mTime, mTime + duration, numFingers, center, radius, Vec2f::zero(), 1.0f, angle );
+		play();
+	}
+	
+	void GestureGenerator::flick( const Vec2f &pos, const Vec2f &velocity, float duration )
+	{
+		addFinger( mTime, mTime + duration, pos, Vec2f::zero(), velocity * duration, 1.0f, 0.0f );
+		play();
+	}
+	
+	void GestureGenerator::chaos( int numUsers, float duration )
+	{
+		// split the bounds into one column per user
+		float columnWidth = mBounds.getWidth() / math<float>::max( 1, numUsers );
+		for( int user = 0; user < numUsers; ++user ) {
+			Rectf column( mBounds.x1 + columnWidth * user, mBounds.y1, mBounds.x1 + columnWidth * ( user + 1 ), mBounds.y2 );
+			double time = mTime + mRand.nextFloat( 0.0f, 0.2f );
+			while( time < mTime + duration - 0.1 ) {
+				float gestureDuration = mRand.nextFloat( 0.1f, math<float>::min( 1.5f, float( mTime + duration - time ) ) );
+				addRandomGesture( time, column, gestureDuration );
+				time += gestureDuration + mRand.nextFloat( 0.05f, 0.3f );
+			}
+		}
+		play();
+	}
+	
+	void GestureGenerator::storm( int numTouches, float duration )
+	{
+		for( int i = 0; i < numTouches; ++i ) {
+			double beginTime = mTime + mRand.nextFloat( 0.0f, duration );
+			double endTime = math<double>::min( beginTime + mRand.nextFloat( 0.03f, 0.25f ), mTime + duration );
+			Vec2f pos( mRand.nextFloat( mBounds.x1, mBounds.x2 ), mRand.nextFloat( mBounds.y1, mBounds.y2 ) );
+			Vec2f slide( mRand.nextFloat( -10.0f, 10.0f ), mRand.nextFloat( -10.0f, 10.0f ) );
+			addFinger( beginTime, endTime, pos, Vec2f::zero(), slide, 1.0f, 0.0f );
+		}
+		play();
+	}
+	
+	void GestureGenerator::randomGesture()
+	{
+		addRandomGesture( mTime, mBounds, 1.0f );
+		play();
+	}
+	
+	
+	void GestureGenerator::addFinger( double beginTime, double endTime, const Vec2f &center, const Vec2f &offset, const Vec2f &translation, float scale, float angle )
+	{
+		Finger finger;
+		finger.mId = mNextId++;
+		finger.mBeginTime = beginTime;
+		finger.mEndTime = math<double>::max( endTime, beginTime );
+		finger.mCenter = center;
+		finger.mOffset = offset;
+		finger.mTranslation = translation;
+		finger.mScale = scale;
+		finger.mAngle = angle;
+		finger.mIsBegun = false;
+		mFingers.push_back( finger );
+	}
+	
+	void GestureGenerator::addCircle( double beginTime, double endTime, int numFingers, const Vec2f &center, float radius, const Vec2f &translation, float scale, float angle )
+	{
+		float startAngle = mRand.nextFloat( 0.0f, 2.0f * M_PI );
+		for( int i = 0; i < numFingers; ++i ) {
+			float a = startAngle + 2.0f * M_PI * i / numFingers;
+			addFinger( beginTime, endTime, center, Vec2f( cosf( a ), sinf( a ) ) * radius, translation, scale, angle );
+		}
+	}
+	
+	void GestureGenerator::addRandomGesture( double beginTime, const Rectf &bounds, float maxDuration )
+	{
+		Vec2f center( mRand.nextFloat( bounds.x1, bounds.x2 ), mRand.nextFloat( bounds.y1, bounds.y2 ) );
+		float size = math<float>::min( bounds.getWidth(), bounds.getHeight() );
+		float duration = mRand.nextFloat( 0.05f, maxDuration );
+		int numFingers = mRand.nextInt( 1, 4 );
+		
+		switch( mRand.nextInt( 4 ) ) {
+			case 0: // drag
+				for( int i = 0; i < numFingers; ++i ) {
+					Vec2f offset( mRand.nextFloat( -40.0f, 40.0f ), mRand.nextFloat( -40.0f, 40.0f ) );
+					addFinger( beginTime, beginTime + duration, center, offset, Vec2f( mRand.nextFloat( -0.5f, 0.5f ), mRand.nextFloat( -0.5f, 0.5f ) ) * size, 1.0f, 0.0f );
+				}
+				break;
+			case 1: // pinch
+				addCircle( beginTime, beginTime + duration, numFingers + 1, center, size * mRand.nextFloat( 0.05f, 0.2f ), Vec2f::zero(), mRand.nextFloat( 0.3f, 3.0f ), 0.0f );
+				break;
+			case 2: // rotate
+				addCircle( beginTime, beginTime + duration, numFingers + 1, center, size * mRand.nextFloat( 0.05f, 0.2f ), Vec2f::zero(), 1.0f, mRand.nextFloat( -3.0f, 3.0f ) );
+				break;
+			default: // flick
+				duration = math<float>::min( duration, 0.15f );
+				addFinger( beginTime, beginTime + duration, center, Vec2f::zero(), Vec2f( mRand.nextFloat( -1.0f, 1.0f ), mRand.nextFloat( -1.0f, 1.0f ) ) * 3000.0f * duration, 1.0f, 0.0f );
+				break;
+		}
+	}
+	
+	void GestureGenerator::play()
+	{
+		double timeStep = 1.0 / mRate;
+		
+		while( ! mFingers.empty() ) {
+			// began touches first, then moves, then ends, each as one event per sample
+			mTouches.clear();
+			for( vector<Finger>::iterator it = mFingers.begin(); it != mFingers.end(); ++it ) {
+				if ( ! it->mIsBegun && it->mBeginTime <= mTime ) {
+					it->mIsBegun = true;
+					it->mPrevPos = calcPos( *it, it->mBeginTime );
+					mTouches.push_back( TouchEvent::Touch( it->mPrevPos, it->mPrevPos, it->mId, mTime, NULL ) );
+				}
+			}
+			emit( TOUCH_BEGAN );
+			
+			mTouches.clear();
+			for( vector<Finger>::iterator it = mFingers.begin(); it != mFingers.end(); ++it ) {
+				if ( it->mIsBegun && it->mBeginTime < mTime && it->mEndTime > mTime ) {
+					Vec2f pos = calcPos( *it, mTime );
+					mTouches.push_back( TouchEvent::Touch( pos, it->mPrevPos, it->mId, mTime, NULL ) );
+					it->mPrevPos = pos;
+				}
+			}
+			emit( TOUCH_MOVED );
+			
+			mTouches.clear();
+			vector<Finger>::iterator it = mFingers.begin();
+			while( it != mFingers.end() ) {
+				if ( it->mIsBegun && it->mEndTime <= mTime ) {
+					Vec2f pos = calcPos( *it, it->mEndTime );
+					mTouches.push_back( TouchEvent::Touch( pos, it->mPrevPos, it->mId, mTime, NULL ) );
+					it = mFingers.erase( it );
+				} else {
+					++it;
+				}
+			}
+			emit( TOUCH_ENDED );
+			
+			mTime += timeStep;
+		}
+	}
+	
+	Vec2f GestureGenerator::calcPos( const Finger &finger, double time )
+	{
+		double length = finger.mEndTime - finger.mBeginTime;
+		float u = ( length > 0.0 ) ? math<float>::clamp( float( ( time - finger.mBeginTime ) / length ), 0.0f, 1.0f ) : 1.0f;
+		
+		Vec2f offset = finger.mOffset * ( 1.0f + ( finger.mScale - 1.0f ) * u );
+		offset.rotate( finger.mAngle * u );
+		Vec2f pos = finger.mCenter + finger.mTranslation * u + offset;
+		
+		if ( mJitter > 0.0f ) pos += Vec2f( mRand.nextFloat( -mJitter, mJitter ), mRand.nextFloat( -mJitter, mJitter ) );
+		return pos;
+	}
+	
+	void GestureGenerator::emit( TouchPhase phase )
+	{
+		if ( ! mTouches.empty() && mTarget ) mTarget( phase, TouchEvent( mTouches ) );
+	}
+	
+}
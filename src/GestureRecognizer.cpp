@@ -0,0 +1,190 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#include "GestureRecognizer.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	GestureRecognizer::GestureRecognizer( GestureType type, int numTouches )
+	: mType( type ), mNumTouches( numTouches ), mNumTaps( 1 )
+	{
+		mMaxMovement = 10.0f; // pixels
+		mMaxTapDuration = 0.3f; // seconds
+		mMaxTapInterval = 0.3f; // seconds
+		mMaxTapDistance = 40.0f; // pixels
+		mPressDuration = ( type == GESTURE_PRESS_DRAG ) ? 0.3f : 0.5f; // seconds
+		mMinSwipeDistance = 80.0f; // pixels
+		mMinSwipeVelocity = 400.0f; // pixels per second
+		mMaxSwipeDuration = 0.5f; // seconds
+		
+		mNumDown = 0;
+		reset();
+	}
+	
+	void GestureRecognizer::reset()
+	{
+		mState = POSSIBLE;
+		mMaxDown = mTapCount = 0;
+		mIsPressed = false;
+		mStartPos = mDownPos = Vec2f::zero();
+		mDownTime = mUpTime = 0.0;
+	}
+	
+	
+	bool GestureRecognizer::touchesBegan( int numTouches, const Vec2f &pos, double time, Gesture * )
+	{
+		int prevDown = mNumDown;
+		mNumDown = numTouches;
+		if ( mState != POSSIBLE ) return false;
+		
+		if ( prevDown == 0 ) {
+			// later taps must follow quickly, and close to the first
+			if ( mTapCount > 0 && ( time - mUpTime > mMaxTapInterval || pos.distance( mStartPos ) > mMaxTapDistance ) ) return fail();
+			if ( mTapCount == 0 ) mStartPos = pos;
+			mDownPos = pos;
+			mDownTime = time;
+			mMaxDown = 0;
+		}
+		mMaxDown = math<int>::max( mMaxDown, numTouches );
+		if ( mMaxDown > mNumTouches ) return fail();
+		
+		// presses and swipes are timed from when the last finger lands
+		if ( mType != GESTURE_TAP && numTouches == mNumTouches ) {
+			mDownPos = pos;
+			mDownTime = time;
+			if ( mType == GESTURE_SWIPE ) mStartPos = pos;
+		}
+		return false;
+	}
+	
+	bool GestureRecognizer::touchesMoved( int numTouches, const Vec2f &pos, double time, Gesture *gesture )
+	{
+		mNumDown = numTouches;
+		
+		if ( mState == ACTIVE ) return report( GESTURE_CHANGED, pos, time, gesture );
+		if ( mState != POSSIBLE ) return false;
+		
+		switch( mType ) {
+			case GESTURE_TAP:
+				if ( isMoved( pos ) ) return fail();
+				return update( time, gesture );
+			case GESTURE_LONG_PRESS:
+				if ( isMoved( pos ) ) return fail();
+				return update( time, gesture );
+			case GESTURE_PRESS_DRAG:
+				update( time, gesture );
+				if ( ! isMoved( pos ) ) return false;
+				if ( ! mIsPressed ) return fail();
+				mState = ACTIVE;
+				return report( GESTURE_BEGAN, pos, time, gesture );
+			case GESTURE_SWIPE:
+				return update( time, gesture );
+		}
+		return false;
+	}
+	
+	bool GestureRecognizer::touchesEnded( int numTouches, const Vec2f &pos, double time, Gesture *gesture )
+	{
+		mNumDown = numTouches;
+		
+		if ( mState == ACTIVE ) {
+			if ( numTouches > 0 ) return false;
+			mState = RECOGNIZED;
+			return report( GESTURE_ENDED, pos, time, gesture );
+		}
+		if ( mState != POSSIBLE ) return false;
+		
+		switch( mType ) {
+			case GESTURE_TAP:
+				if ( numTouches > 0 ) return false;
+				if ( mMaxDown != mNumTouches || time - mDownTime > mMaxTapDuration || isMoved( pos ) ) return fail();
+				mUpTime = time;
+				if ( ++mTapCount < mNumTaps ) return false;
+				mState = RECOGNIZED;
+				return report( GESTURE_ENDED, pos, time, gesture );
+			case GESTURE_SWIPE: {
+				if ( numTouches > 0 ) return false;
+				double duration = time - mDownTime;
+				float distance = pos.distance( mStartPos );
+				if ( mMaxDown != mNumTouches || duration > mMaxSwipeDuration || distance < mMinSwipeDistance ) return fail();
+				if ( duration > 0.0 && distance / duration < mMinSwipeVelocity ) return fail();
+				mState = RECOGNIZED;
+				return report( GESTURE_ENDED, pos, time, gesture );
+			}
+			default:
+				// lifted before the press was long enough
+				return fail();
+		}
+	}
+	
+	bool GestureRecognizer::update( double time, Gesture *gesture )
+	{
+		if ( mState != POSSIBLE ) return false;
+		
+		switch( mType ) {
+			case GESTURE_TAP:
+				if ( mNumDown > 0 && time - mDownTime > mMaxTapDuration ) return fail();
+				if ( mNumDown == 0 && mTapCount > 0 && time - mUpTime > mMaxTapInterval ) return fail();
+				break;
+			case GESTURE_LONG_PRESS:
+				if ( mNumDown == mNumTouches && time - mDownTime >= mPressDuration ) {
+					mState = ACTIVE;
+					return report( GESTURE_BEGAN, mDownPos, time, gesture );
+				}
+				break;
+			case GESTURE_PRESS_DRAG:
+				if ( mNumDown == mNumTouches && time - mDownTime >= mPressDuration ) mIsPressed = true;
+				break;
+			case GESTURE_SWIPE:
+				if ( mNumDown > 0 && time - mDownTime > mMaxSwipeDuration ) return fail();
+				break;
+		}
+		return false;
+	}
+	
+	
+	bool GestureRecognizer::report( GesturePhase phase, const Vec2f &pos, double time, Gesture *gesture )
+	{
+		gesture->mRecognizer = -1;
+		gesture->mType = mType;
+		gesture->mPhase = phase;
+		gesture->mNumTouches = mNumTouches;
+		gesture->mNumTaps = mTapCount;
+		gesture->mPos = pos;
+		gesture->mStartPos = mStartPos;
+		gesture->mVelocity = Vec2f::zero();
+		if ( mType == GESTURE_SWIPE && time > mDownTime ) gesture->mVelocity = ( pos - mStartPos ) / float( time - mDownTime );
+		gesture->mTime = time;
+		return true;
+	}
+	
+}
@@ -0,0 +1,315 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+#include <cfloat>
+
+#include "GestureSpotter.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	GestureSpotter::GestureSpotter()
+	: mPendingHead( 0 ), mStepLength( 10.0f ), mMaxCost( 0.15f ), mWarpPenalty( 0.1f )
+	{}
+	
+	int GestureSpotter::addTemplate( const string &name, const vector<Vec2f> &points )
+	{
+		if ( points.empty() ) return -1;
+		
+		// resampled exactly like the streams, so both see the same steps
+		vector<Vec2f> dirs;
+		Vec2f anchor = points.front();
+		for( vector<Vec2f>::const_iterator it = points.begin() + 1; it != points.end() && int( dirs.size() ) < kMaxTemplateLength; ++it ) {
+			float dist = anchor.distance( *it );
+			while( dist >= mStepLength && int( dirs.size() ) < kMaxTemplateLength ) {
+				Vec2f dir = ( *it - anchor ) / dist;
+				dirs.push_back( dir );
+				anchor += dir * mStepLength;
+				dist -= mStepLength;
+			}
+		}
+		if ( dirs.size() < 2 ) return -1;
+		
+		Template tmpl;
+		tmpl.mName = name;
+		tmpl.mOffset = mDirX.size();
+		tmpl.mLength = dirs.size();
+		mTemplates.push_back( tmpl );
+		for( vector<Vec2f>::const_iterator it = dirs.begin(); it != dirs.end(); ++it ) {
+			mDirX.push_back( it->x );
+			mDirY.push_back( it->y );
+		}
+		
+		// touches already down start over with the new template
+		for( vector<Stream>::iterator it = mStreams.begin(); it != mStreams.end(); ++it ) resetStream( &*it );
+		return mTemplates.size() - 1;
+	}
+	
+	void GestureSpotter::clear()
+	{
+		mTemplates.clear();
+		mDirX.clear();
+		mDirY.clear();
+		mStreams.clear();
+		mPending.clear();
+		mPendingHead = 0;
+	}
+	
+	
+	void GestureSpotter::touchesBegan( const TouchPointSpan &touchPoints )
+	{
+		for( TouchPointSpan::const_iterator it = touchPoints.begin(); it != touchPoints.end(); ++it ) {
+			Stream *stream = findStream( it->getId() );
+			if ( ! stream ) {
+				// reuse a lifted touch's stream, so its cells are only allocated once
+				for( vector<Stream>::iterator streamIt = mStreams.begin(); streamIt != mStreams.end() && ! stream; ++streamIt )
+					if ( ! streamIt->mIsActive ) stream = &*streamIt;
+				if ( ! stream ) {
+					mStreams.push_back( Stream() );
+					stream = &mStreams.back();
+				}
+			}
+			stream->mId = it->getId();
+			beginStream( stream, it->getPos(), it->getTime() );
+		}
+	}
+	
+	void GestureSpotter::touchesMoved( const TouchPointSpan &touchPoints )
+	{
+		for( TouchPointSpan::const_iterator it = touchPoints.begin(); it != touchPoints.end(); ++it ) {
+			Stream *stream = findStream( it->getId() );
+			if ( stream ) moveStream( stream, it->getPos(), it->getTime() );
+		}
+	}
+	
+	void GestureSpotter::touchesEnded( const TouchPointSpan &touchPoints )
+	{
+		for( TouchPointSpan::const_iterator it = touchPoints.begin(); it != touchPoints.end(); ++it ) {
+			Stream *stream = findStream( it->getId() );
+			if ( ! stream ) continue;
+			
+			moveStream( stream, it->getPos(), it->getTime() );
+			for( size_t t = 0; t < mTemplates.size(); ++t )
+				if ( stream->mMatches[t].mBestCost < FLT_MAX ) report( stream, t );
+			stream->mIsActive = false;
+		}
+	}
+	
+	void GestureSpotter::touchesCancelled( const TouchPointSpan &touchPoints )
+	{
+		for( TouchPointSpan::const_iterator it = touchPoints.begin(); it != touchPoints.end(); ++it ) {
+			Stream *stream = findStream( it->getId() );
+			if ( stream ) stream->mIsActive = false;
+		}
+	}
+	
+	bool GestureSpotter::popGesture( SpottedGesture *gesture )
+	{
+		if ( mPendingHead >= mPending.size() ) return false;
+		
+		*gesture = mPending[mPendingHead++];
+		if ( mPendingHead == mPending.size() ) {
+			mPending.clear();
+			mPendingHead = 0;
+		}
+		return true;
+	}
+	
+	
+	GestureSpotter::Stream* GestureSpotter::findStream( uint32_t id )
+	{
+		for( vector<Stream>::iterator it = mStreams.begin(); it != mStreams.end(); ++it )
+			if ( it->mIsActive && it->mId == id ) return &*it;
+		return NULL;
+	}
+	
+	void GestureSpotter::beginStream( Stream *stream, const Vec2f &pos, double time )
+	{
+		stream->mIsActive = true;
+		stream->mAnchor = pos;
+		resetStream( stream );
+		stream->mHistoryPos[0] = pos;
+		stream->mHistoryTime[0] = time;
+	}
+	
+	void GestureSpotter::resetStream( Stream *stream )
+	{
+		Cell dead = { FLT_MAX, 0 };
+		stream->mCells.assign( mDirX.size(), dead );
+		
+		Match idle = { 0, -1, FLT_MAX, 0, 0 };
+		stream->mMatches.assign( mTemplates.size(), idle );
+		stream->mNumSteps = 0;
+	}
+	
+	void GestureSpotter::moveStream( Stream *stream, const Vec2f &pos, double time )
+	{
+		Vec2f delta = pos - stream->mAnchor;
+		float dist = delta.length();
+		if ( dist < mStepLength ) return;
+		
+		// a long jump is spread over fewer, longer steps, so no event costs more than kMaxStepsPerEvent steps
+		int numSteps = int( dist / mStepLength );
+		float stride = mStepLength;
+		if ( numSteps > kMaxStepsPerEvent ) {
+			numSteps = kMaxStepsPerEvent;
+			stride = dist / numSteps;
+		}
+		
+		Vec2f dir = delta / dist;
+		for( int i = 0; i < numSteps; ++i ) {
+			stream->mAnchor += dir * stride;
+			step( stream, dir, stream->mAnchor, time );
+		}
+	}
+	
+	void GestureSpotter::step( Stream *stream, const Vec2f &dir, const Vec2f &pos, double time )
+	{
+		uint32_t t = ++stream->mNumSteps;
+		stream->mHistoryPos[t % kHistorySize] = pos;
+		stream->mHistoryTime[t % kHistorySize] = time;
+		
+		for( size_t k = 0; k < mTemplates.size(); ++k ) {
+			const Template &tmpl = mTemplates[k];
+			const float *dirX = &mDirX[tmpl.mOffset];
+			const float *dirY = &mDirY[tmpl.mOffset];
+			Cell *cells = &stream->mCells[tmpl.mOffset];
+			Match &match = stream->mMatches[k];
+			float maxCost = mMaxCost * tmpl.mLength;
+			
+			// one column of SPRING: every path may start fresh at this step, through the zero cost cell before the template
+			float leftCost = 0.0f, diagCost = 0.0f;
+			uint32_t leftStart = t, diagStart = t;
+			int lo = tmpl.mLength, hi = -1;
+			bool isSettled = true;
+			int j = 0;
+			while( j < tmpl.mLength ) {
+				// cells outside the last live band are dead, and only a live neighbor can revive them
+				if ( leftCost == FLT_MAX && diagCost == FLT_MAX ) {
+					if ( j > match.mHi ) break;
+					if ( j < match.mLo ) {
+						j = match.mLo;
+						continue;
+					}
+				}
+				
+				float upCost = cells[j].mCost;
+				uint32_t upStart = cells[j].mStart;
+				
+				// stretching either path costs extra, so the proportions must match too
+				float cost = diagCost;
+				uint32_t start = diagStart;
+				if ( leftCost + mWarpPenalty < cost ) {
+					cost = leftCost + mWarpPenalty;
+					start = leftStart;
+				}
+				if ( upCost + mWarpPenalty < cost ) {
+					cost = upCost + mWarpPenalty;
+					start = upStart;
+				}
+				if ( cost < FLT_MAX ) {
+					cost += 1.0f - ( dir.x * dirX[j] + dir.y * dirY[j] );
+					// costs never shrink along a path, so one past the max is abandoned for good
+					if ( cost > maxCost ) cost = FLT_MAX;
+				}
+				
+				diagCost = upCost;
+				diagStart = upStart;
+				cells[j].mCost = leftCost = cost;
+				cells[j].mStart = leftStart = start;
+				
+				if ( cost < FLT_MAX ) {
+					lo = math<int>::min( lo, j );
+					hi = j;
+					// a path overlapping the best match could still beat it
+					if ( cost < match.mBestCost && start <= match.mBestEnd ) isSettled = false;
+				}
+				++j;
+			}
+			match.mLo = lo;
+			match.mHi = hi;
+			
+			if ( match.mBestCost < FLT_MAX && isSettled ) report( stream, k );
+			
+			const Cell &last = cells[tmpl.mLength - 1];
+			if ( last.mCost < match.mBestCost ) {
+				match.mBestCost = last.mCost;
+				match.mBestStart = last.mStart;
+				match.mBestEnd = t;
+			}
+		}
+	}
+	
+	void GestureSpotter::report( Stream *stream, int t )
+	{
+		const Template &tmpl = mTemplates[t];
+		Match &match = stream->mMatches[t];
+		
+		// a match's first step leaves from the position before it
+		int startIndex = findHistory( *stream, match.mBestStart - 1 );
+		int endIndex = findHistory( *stream, match.mBestEnd );
+		
+		SpottedGesture gesture;
+		gesture.mTemplate = t;
+		gesture.mName = tmpl.mName;
+		gesture.mTouchId = stream->mId;
+		gesture.mCost = match.mBestCost;
+		gesture.mConfidence = 1.0f - match.mBestCost / ( mMaxCost * tmpl.mLength );
+		gesture.mStartPos = stream->mHistoryPos[startIndex];
+		gesture.mStartTime = stream->mHistoryTime[startIndex];
+		gesture.mEndPos = stream->mHistoryPos[endIndex];
+		gesture.mEndTime = stream->mHistoryTime[endIndex];
+		mPending.push_back( gesture );
+		
+		// paths that overlap the reported match can't report it again
+		Cell *cells = &stream->mCells[tmpl.mOffset];
+		int lo = tmpl.mLength, hi = -1;
+		for( int j = math<int>::max( match.mLo, 0 ); j <= match.mHi; ++j ) {
+			if ( cells[j].mCost == FLT_MAX ) continue;
+			if ( cells[j].mStart <= match.mBestEnd ) {
+				cells[j].mCost = FLT_MAX;
+			} else {
+				lo = math<int>::min( lo, j );
+				hi = j;
+			}
+		}
+		match.mLo = lo;
+		match.mHi = hi;
+		match.mBestCost = FLT_MAX;
+	}
+	
+	int GestureSpotter::findHistory( const Stream &stream, uint32_t step ) const
+	{
+		// matches older than the history report its oldest step instead
+		if ( stream.mNumSteps - step >= uint32_t( kHistorySize ) ) step = stream.mNumSteps - kHistorySize + 1;
+		return step % kHistorySize;
+	}
+	
+}
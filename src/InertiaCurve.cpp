@@ -0,0 +1,67 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#include "InertiaCurve.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	InertiaCurve InertiaCurve::fromVelDecay( float velDecay )
+	{
+		// the old per-frame factor was velDecay * ( 1 - deltaTime ), tuned at 60 fps
+		const float kReferenceRate = 60.0f;
+		float frameFactor = math<float>::clamp( velDecay * ( 1.0f - 1.0f / kReferenceRate ), 0.0001f, 0.9999f );
+		return InertiaCurve( -math<float>::log( frameFactor ) * kReferenceRate );
+	}
+	
+	void InertiaCurve::setDecayRate( float decayRate )
+	{
+		mDecayRate = math<float>::max( decayRate, 0.0001f );
+	}
+	
+	float InertiaCurve::getVelocityFactor( float time ) const
+	{
+		return math<float>::exp( -mDecayRate * time );
+	}
+	
+	float InertiaCurve::getDistanceFactor( float time ) const
+	{
+		return ( 1.0f - math<float>::exp( -mDecayRate * time ) ) / mDecayRate;
+	}
+	
+	float InertiaCurve::getSettleTime( float speed, float threshold ) const
+	{
+		speed = math<float>::abs( speed );
+		if ( speed <= threshold ) return 0.0f;
+		return math<float>::log( speed / threshold ) / mDecayRate;
+	}
+	
+}
@@ -0,0 +1,363 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define PIVOT_MOMENTUMBATCH_SSE
+#endif
+
+#include "MomentumBatch.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	MomentumBatch::MomentumBatch()
+	: mNumLanes( 0 ), mDeltaTime( 0.0f )
+	{}
+	
+	MomentumBatch::~MomentumBatch()
+	{
+		clear();
+	}
+	
+	void MomentumBatch::addObject( Card *card )
+	{
+		addObject( card, CARD );
+	}
+	
+	void MomentumBatch::addObject( Trackball *trackball )
+	{
+		addObject( trackball, TRACKBALL );
+	}
+	
+	void MomentumBatch::addObject( Trackball3D *trackball )
+	{
+		addObject( trackball, TRACKBALL_3D );
+	}
+	
+	void MomentumBatch::addObject( TouchObject *object, Kind kind )
+	{
+		TouchObject::MomentumLink &link = object->mMomentumLink;
+		if ( link.mBatch == this ) return;
+		if ( link.mBatch ) link.mBatch->removeObject( object );
+		
+		// stepped once per batch update, so there are no fixed steps to blend between
+		object->disableFixedTimestep();
+		
+		link.mBatch = this;
+		link.mKind = kind;
+		link.mIsActive = false;
+		link.mLane = -1;
+		mObjects.push_back( object );
+		wake( object );
+	}
+	
+	void MomentumBatch::removeObject( TouchObject *object )
+	{
+		TouchObject::MomentumLink &link = object->mMomentumLink;
+		if ( link.mBatch != this ) return;
+		
+		// the object integrates itself from here on
+		if ( link.mIsActive ) {
+			storeVelocities( object );
+			removeLane( link.mLane );
+		}
+		mObjects.erase( find( mObjects.begin(), mObjects.end(), object ) );
+		link.mBatch = NULL;
+		link.mIsActive = false;
+		link.mLane = -1;
+	}
+	
+	void MomentumBatch::clear()
+	{
+		for( vector<TouchObject*>::iterator it = mActive.begin(); it != mActive.end(); ++it )
+			storeVelocities( *it );
+		for( vector<TouchObject*>::iterator it = mObjects.begin(); it != mObjects.end(); ++it ) {
+			(*it)->mMomentumLink.mBatch = NULL;
+			(*it)->mMomentumLink.mIsActive = false;
+			(*it)->mMomentumLink.mLane = -1;
+		}
+		mObjects.clear();
+		mActive.clear();
+		resizeLanes();
+	}
+	
+	void MomentumBatch::wake( TouchObject *object )
+	{
+		TouchObject::MomentumLink &link = object->mMomentumLink;
+		link.mNeedsGather = true;
+		if ( link.mIsActive || ! object->mIsInMotion ) return;
+		link.mIsActive = true;
+		link.mLane = mActive.size();
+		mActive.push_back( object );
+		resizeLanes();
+	}
+	
+	void MomentumBatch::storeVelocities( TouchObject *object )
+	{
+		const TouchObject::MomentumLink &link = object->mMomentumLink;
+		if ( link.mIsActive && ! link.mNeedsGather ) writeVelocities( link.mLane, object );
+	}
+	
+	void MomentumBatch::removeLane( int lane )
+	{
+		int last = mActive.size() - 1;
+		if ( lane != last ) {
+			mActive[lane] = mActive[last];
+			mActive[lane]->mMomentumLink.mLane = lane;
+			mVelX[lane] = mVelX[last];
+			mVelY[lane] = mVelY[last];
+			mVelZ[lane] = mVelZ[last];
+			mRotVel[lane] = mRotVel[last];
+			mScaleVel[lane] = mScaleVel[last];
+			mDecayRate[lane] = mDecayRate[last];
+			mTravel[lane] = mTravel[last];
+			mVelFactor[lane] = mVelFactor[last];
+		}
+		mActive.pop_back();
+		resizeLanes();
+	}
+	
+	void MomentumBatch::resizeLanes()
+	{
+		mNumLanes = ( mActive.size() + kLaneWidth - 1 ) / kLaneWidth * kLaneWidth;
+		mVelX.resize( mNumLanes, 0.0f );
+		mVelY.resize( mNumLanes, 0.0f );
+		mVelZ.resize( mNumLanes, 0.0f );
+		mRotVel.resize( mNumLanes, 0.0f );
+		mScaleVel.resize( mNumLanes, 0.0f );
+		mDecayRate.resize( mNumLanes, 1.0f );
+		mTravel.resize( mNumLanes, 0.0f );
+		mVelFactor.resize( mNumLanes, 0.0f );
+		mStepX.resize( mNumLanes, 0.0f );
+		mStepY.resize( mNumLanes, 0.0f );
+		mStepZ.resize( mNumLanes, 0.0f );
+		mStepRot.resize( mNumLanes, 0.0f );
+		mStepScale.resize( mNumLanes, 0.0f );
+	}
+	
+	
+	void MomentumBatch::update( float deltaTime )
+	{
+		// exp() has no SSE form, so the factors are only re-evaluated when the frame time changes or a lane is loaded
+		if ( deltaTime != mDeltaTime ) {
+			mDeltaTime = deltaTime;
+			for( size_t i = 0; i < mActive.size(); ++i )
+				updateFactors( i );
+		}
+		
+		for( size_t i = 0; i < mActive.size(); ++i ) {
+			TouchObject *object = mActive[i];
+			if ( ! object->mIsInMotion ) continue;
+			// still held by a touch: only rotation/scale coast, which the object's own integrate() handles
+			if ( object->mTouchPivot.numTouchPoints() > 0 ) {
+				object->mMomentumLink.mNeedsGather = true;
+				object->integrate( deltaTime );
+			} else if ( object->mMomentumLink.mNeedsGather ) {
+				gather( i, object );
+				object->mMomentumLink.mNeedsGather = false;
+			}
+		}
+		
+		integrateLanes();
+		
+		for( size_t i = 0; i < mActive.size(); ++i ) {
+			TouchObject *object = mActive[i];
+			if ( object->mIsInMotion && ! object->mMomentumLink.mNeedsGather ) scatter( i, object, deltaTime );
+		}
+		
+		// put objects at rest to sleep
+		size_t i = 0;
+		while( i < mActive.size() ) {
+			if ( mActive[i]->mIsInMotion ) {
+				++i;
+			} else {
+				mActive[i]->mMomentumLink.mIsActive = false;
+				mActive[i]->mMomentumLink.mLane = -1;
+				removeLane( i );
+			}
+		}
+	}
+	
+	void MomentumBatch::updateFactors( int lane )
+	{
+		InertiaCurve inertia( mDecayRate[lane] );
+		mTravel[lane] = inertia.getDistanceFactor( mDeltaTime );
+		mVelFactor[lane] = inertia.getVelocityFactor( mDeltaTime );
+	}
+	
+	void MomentumBatch::gather( int lane, TouchObject *object )
+	{
+		mDecayRate[lane] = object->getInertiaCurve().getDecayRate();
+		updateFactors( lane );
+		
+		switch( object->mMomentumLink.mKind ) {
+			case CARD: {
+				Card *card = static_cast<Card*>( object );
+				mVelX[lane] = card->mPivotPosVel.x;
+				mVelY[lane] = card->mPivotPosVel.y;
+				mVelZ[lane] = 0.0f;
+				mRotVel[lane] = card->mRotVel;
+				mScaleVel[lane] = card->mScaleVel;
+				break;
+			}
+			case TRACKBALL: {
+				Trackball *trackball = static_cast<Trackball*>( object );
+				mVelX[lane] = trackball->mOrientationVel.x;
+				mVelY[lane] = trackball->mOrientationVel.y;
+				mVelZ[lane] = trackball->mOrientationVel.z;
+				mRotVel[lane] = trackball->mRotVel;
+				mScaleVel[lane] = trackball->mScaleVel;
+				break;
+			}
+			case TRACKBALL_3D: {
+				Trackball3D *trackball = static_cast<Trackball3D*>( object );
+				mVelX[lane] = trackball->mOrientationVel.x;
+				mVelY[lane] = trackball->mOrientationVel.y;
+				mVelZ[lane] = trackball->mOrientationVel.z;
+				mRotVel[lane] = trackball->mRotVel;
+				mScaleVel[lane] = trackball->mScaleVel;
+				break;
+			}
+		}
+	}
+	
+	void MomentumBatch::integrateLanes()
+	{
+		// same steps as Card::integrate() and Trackball::integrate(): advance by the distance covered, then decay the velocities
+#if defined( PIVOT_MOMENTUMBATCH_SSE )
+		for( int i = 0; i < mNumLanes; i += 4 ) {
+			__m128 travel = _mm_loadu_ps( &mTravel[i] );
+			__m128 velFactor = _mm_loadu_ps( &mVelFactor[i] );
+			
+			__m128 velX = _mm_loadu_ps( &mVelX[i] );
+			__m128 velY = _mm_loadu_ps( &mVelY[i] );
+			__m128 velZ = _mm_loadu_ps( &mVelZ[i] );
+			__m128 rotVel = _mm_loadu_ps( &mRotVel[i] );
+			__m128 scaleVel = _mm_loadu_ps( &mScaleVel[i] );
+			
+			_mm_storeu_ps( &mStepX[i], _mm_mul_ps( velX, travel ) );
+			_mm_storeu_ps( &mStepY[i], _mm_mul_ps( velY, travel ) );
+			_mm_storeu_ps( &mStepZ[i], _mm_mul_ps( velZ, travel ) );
+			_mm_storeu_ps( &mStepRot[i], _mm_mul_ps( rotVel, travel ) );
+			_mm_storeu_ps( &mStepScale[i], _mm_mul_ps( scaleVel, travel ) );
+			
+			_mm_storeu_ps( &mVelX[i], _mm_mul_ps( velX, velFactor ) );
+			_mm_storeu_ps( &mVelY[i], _mm_mul_ps( velY, velFactor ) );
+			_mm_storeu_ps( &mVelZ[i], _mm_mul_ps( velZ, velFactor ) );
+			_mm_storeu_ps( &mRotVel[i], _mm_mul_ps( rotVel, velFactor ) );
+			_mm_storeu_ps( &mScaleVel[i], _mm_mul_ps( scaleVel, velFactor ) );
+		}
+#else
+		for( int i = 0; i < mNumLanes; ++i ) {
+			mStepX[i] = mVelX[i] * mTravel[i];
+			mStepY[i] = mVelY[i] * mTravel[i];
+			mStepZ[i] = mVelZ[i] * mTravel[i];
+			mStepRot[i] = mRotVel[i] * mTravel[i];
+			mStepScale[i] = mScaleVel[i] * mTravel[i];
+			
+			mVelX[i] *= mVelFactor[i];
+			mVelY[i] *= mVelFactor[i];
+			mVelZ[i] *= mVelFactor[i];
+			mRotVel[i] *= mVelFactor[i];
+			mScaleVel[i] *= mVelFactor[i];
+		}
+#endif
+	}
+	
+	void MomentumBatch::scatter( int lane, TouchObject *object, float deltaTime )
+	{
+		// the object's own velocities are still the larger ones loaded into the lane, so endStep() can't come to rest on them.
+		// Once the lane's are small enough to, they're written back for endStep() to make the call and coast the remainder.
+		switch( object->mMomentumLink.mKind ) {
+			case CARD: {
+				Card *card = static_cast<Card*>( object );
+				card->mRot += mStepRot[lane];
+				card->mScale += mStepScale[lane];
+				card->mPivotPos += Vec2f( mStepX[lane], mStepY[lane] );
+				if ( mVelX[lane] * mVelX[lane] + mVelY[lane] * mVelY[lane] < 0.01f * 0.01f && math<float>::abs( mRotVel[lane] ) < 0.0001f
+					&& math<float>::abs( mScaleVel[lane] ) < 0.000001f )
+					writeVelocities( lane, object );
+				card->endStep( deltaTime );
+				break;
+			}
+			case TRACKBALL: {
+				Trackball *trackball = static_cast<Trackball*>( object );
+				trackball->mBaseArcball.coast( Vec3f( mStepX[lane], mStepY[lane], mStepZ[lane] ) );
+				trackball->mRot += mStepRot[lane];
+				if ( mVelX[lane] * mVelX[lane] + mVelY[lane] * mVelY[lane] + mVelZ[lane] * mVelZ[lane] < 0.00001f * 0.00001f
+					&& math<float>::abs( mRotVel[lane] ) < 0.00001f && math<float>::abs( mScaleVel[lane] ) < 0.0000001f )
+					writeVelocities( lane, object );
+				trackball->endStep( deltaTime );
+				break;
+			}
+			case TRACKBALL_3D: {
+				Trackball3D *trackball = static_cast<Trackball3D*>( object );
+				trackball->mBaseArcball.coast( Vec3f( mStepX[lane], mStepY[lane], mStepZ[lane] ) );
+				trackball->mRot += mStepRot[lane];
+				if ( mVelX[lane] * mVelX[lane] + mVelY[lane] * mVelY[lane] + mVelZ[lane] * mVelZ[lane] < 0.00001f * 0.00001f
+					&& math<float>::abs( mRotVel[lane] ) < 0.00001f && math<float>::abs( mScaleVel[lane] ) < 0.0000001f )
+					writeVelocities( lane, object );
+				trackball->endStep( deltaTime );
+				break;
+			}
+		}
+	}
+	
+	void MomentumBatch::writeVelocities( int lane, TouchObject *object )
+	{
+		switch( object->mMomentumLink.mKind ) {
+			case CARD: {
+				Card *card = static_cast<Card*>( object );
+				card->mPivotPosVel = Vec2f( mVelX[lane], mVelY[lane] );
+				card->mRotVel = mRotVel[lane];
+				card->mScaleVel = mScaleVel[lane];
+				break;
+			}
+			case TRACKBALL: {
+				Trackball *trackball = static_cast<Trackball*>( object );
+				trackball->mOrientationVel = Vec3f( mVelX[lane], mVelY[lane], mVelZ[lane] );
+				trackball->mRotVel = mRotVel[lane];
+				trackball->mScaleVel = mScaleVel[lane];
+				break;
+			}
+			case TRACKBALL_3D: {
+				Trackball3D *trackball = static_cast<Trackball3D*>( object );
+				trackball->mOrientationVel = Vec3f( mVelX[lane], mVelY[lane], mVelZ[lane] );
+				trackball->mRotVel = mRotVel[lane];
+				trackball->mScaleVel = mScaleVel[lane];
+				break;
+			}
+		}
+	}
+	
+}
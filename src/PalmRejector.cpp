@@ -0,0 +1,187 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#endif
+
+#include "PalmRejector.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	PalmRejector::PalmRejector()
+	: mMaxContactSize( 50.0f ), mBurstRadius( 30.0f ), mBurstTime( 0.08f ), mSettleRadius( 100.0f ), mSettleTime( 0.3f ), mMaxBurstSize( 2 )
+	{}
+	
+	void PalmRejector::readContactSizes( const vector<TouchEvent::Touch> &touches )
+	{
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt ) {
+			Vec2f size;
+			if ( readContactSize( *touchIt, &size ) ) mContactSizes.push_back( make_pair( touchIt->getId(), size ) );
+		}
+		
+		// sizes of touches that never got dispatched
+		const size_t maxContactSizes = 64;
+		if ( mContactSizes.size() > maxContactSizes ) mContactSizes.erase( mContactSizes.begin(), mContactSizes.end() - maxContactSizes );
+	}
+	
+	void PalmRejector::touchesBegan( vector<TouchEvent::Touch> *touches, vector<TouchEvent::Touch> *cancelledTouches )
+	{
+		if ( touches->empty() ) return;
+		double time = touches->front().getTime();
+		
+		// forget contacts too old to be part of a burst or settling palm
+		double window = math<float>::max( mBurstTime, mSettleTime );
+		vector<Contact>::iterator contactIt = mContacts.begin();
+		while( contactIt != mContacts.end() && time - contactIt->mTouch.getTime() > window )
+			++contactIt;
+		mContacts.erase( mContacts.begin(), contactIt );
+		
+		int first = mContacts.size();
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches->begin(); touchIt != touches->end(); ++touchIt ) {
+			Contact contact;
+			contact.mTouch = *touchIt;
+			contact.mIsRejected = contact.mIsDelivered = contact.mIsEnded = false;
+			mContacts.push_back( contact );
+		}
+		for( int i = first; i < (int)mContacts.size(); ++i )
+			classify( i );
+		
+		// the first contacts of a palm look like fingers until the rest land, so take them back
+		for( int i = 0; i < first; ++i ) {
+			Contact &contact = mContacts[i];
+			if ( contact.mIsRejected && contact.mIsDelivered && ! contact.mIsEnded ) {
+				Vec2f pos = contact.mTouch.getPos();
+				cancelledTouches->push_back( TouchEvent::Touch( pos, pos, contact.mTouch.getId(), time, NULL ) );
+				contact.mIsDelivered = false;
+			}
+		}
+		
+		int numAccepted = 0;
+		for( int i = first; i < (int)mContacts.size(); ++i ) {
+			Contact &contact = mContacts[i];
+			if ( contact.mIsRejected ) continue;
+			contact.mIsDelivered = true;
+			(*touches)[numAccepted++] = contact.mTouch;
+		}
+		touches->resize( numAccepted );
+	}
+	
+	void PalmRejector::touchesMoved( vector<TouchEvent::Touch> *touches )
+	{
+		if ( mRejectedIds.empty() ) return;
+		
+		int numAccepted = 0;
+		for( size_t i = 0; i < touches->size(); ++i )
+			if ( ! isRejected( (*touches)[i].getId() ) ) (*touches)[numAccepted++] = (*touches)[i];
+		touches->resize( numAccepted );
+	}
+	
+	void PalmRejector::touchesEnded( vector<TouchEvent::Touch> *touches )
+	{
+		int numAccepted = 0;
+		for( size_t i = 0; i < touches->size(); ++i ) {
+			uint32_t id = (*touches)[i].getId();
+			for( vector<Contact>::iterator contactIt = mContacts.begin(); contactIt != mContacts.end(); ++contactIt ) {
+				if ( contactIt->mTouch.getId() == id ) contactIt->mIsEnded = true;
+			}
+			if ( mRejectedIds.erase( id ) == 0 ) (*touches)[numAccepted++] = (*touches)[i];
+		}
+		touches->resize( numAccepted );
+	}
+	
+	void PalmRejector::clear()
+	{
+		mContacts.clear();
+		mRejectedIds.clear();
+		mContactSizes.clear();
+	}
+	
+	void PalmRejector::classify( int index )
+	{
+		Contact &contact = mContacts[index];
+		Vec2f pos = contact.mTouch.getPos();
+		double time = contact.mTouch.getTime();
+		
+		bool isRejected = false;
+		for( vector< pair<uint32_t, Vec2f> >::iterator sizeIt = mContactSizes.begin(); sizeIt != mContactSizes.end(); ++sizeIt ) {
+			if ( sizeIt->first == contact.mTouch.getId() ) {
+				isRejected = math<float>::max( sizeIt->second.x, sizeIt->second.y ) > mMaxContactSize;
+				mContactSizes.erase( sizeIt );
+				break;
+			}
+		}
+		
+		float settleRadiusSq = mSettleRadius * mSettleRadius;
+		float burstRadiusSq = mBurstRadius * mBurstRadius;
+		int burstSize = 1;
+		for( int i = 0; i < index; ++i ) {
+			const Contact &other = mContacts[i];
+			float distSq = other.mTouch.getPos().distanceSquared( pos );
+			double age = time - other.mTouch.getTime();
+			if ( other.mIsRejected && age <= mSettleTime && distSq <= settleRadiusSq ) isRejected = true;
+			if ( age <= mBurstTime && distSq <= burstRadiusSq ) ++burstSize;
+		}
+		
+		// a burst takes every contact in it down with the new one
+		if ( burstSize > mMaxBurstSize ) {
+			isRejected = true;
+			for( int i = 0; i < index; ++i ) {
+				Contact &other = mContacts[i];
+				if ( other.mIsRejected || time - other.mTouch.getTime() > mBurstTime || other.mTouch.getPos().distanceSquared( pos ) > burstRadiusSq ) continue;
+				other.mIsRejected = true;
+				if ( ! other.mIsEnded ) mRejectedIds.insert( other.mTouch.getId() );
+			}
+		}
+		
+		if ( isRejected ) {
+			contact.mIsRejected = true;
+			mRejectedIds.insert( contact.mTouch.getId() );
+		}
+	}
+	
+	bool PalmRejector::readContactSize( const TouchEvent::Touch &touch, Vec2f *size ) const
+	{
+		if ( mContactSizeFn ) return mContactSizeFn( touch, size );
+#if defined( CINDER_MSW )
+		// Cinder passes the TOUCHINPUT along, which measures the contact in hundredths of a pixel
+		const TOUCHINPUT *input = static_cast<const TOUCHINPUT*>( touch.getNative() );
+		if ( input && ( input->dwMask & TOUCHINPUTMASKF_CONTACTAREA ) ) {
+			*size = Vec2f( float( input->cxContact ), float( input->cyContact ) ) * 0.01f;
+			return true;
+		}
+#endif
+		return false;
+	}
+	
+}
@@ -160,7 +160,7 @@ namespace Pivot {
 	
 	// Debug draw touches
 	void Renderer::drawTouches( TouchObject &touchObject ) {
-		list<TouchPoint> touchPoints = touchObject.getTouchPoints();
+		const TouchPointSet &touchPoints = touchObject.getTouchPoints();
 		
 		gl::pushMatrices();
 		
@@ -171,14 +171,14 @@ namespace Pivot {
 		gl::color( touchObject.getDebugColor() );
 		
 		if ( touchObject.getCaptureMode() ) {
-			for( list<TouchPoint>::iterator touchPointIt = touchPoints.begin(); touchPointIt != touchPoints.end(); ++touchPointIt ) {
+			for( TouchPointSet::const_iterator touchPointIt = touchPoints.begin(); touchPointIt != touchPoints.end(); ++touchPointIt ) {
                 //glLineWidth( 0.0f );
                 //gl::drawString( ci::toString( touchPointIt->getId() ), touchPointIt->getPos() + Vec2f( 30.0f, -5.0f ), touchObject.getDebugColor(), Font( "Helvetica", 16.0f ) );
 				glLineWidth( 2.5f );
 				gl::drawStrokedCircle( touchPointIt->getPos(), 20.0f );
 			}
 		} else {
-			for( list<TouchPoint>::iterator touchPointIt = touchPoints.begin(); touchPointIt != touchPoints.end(); ++touchPointIt ) {
+			for( TouchPointSet::const_iterator touchPointIt = touchPoints.begin(); touchPointIt != touchPoints.end(); ++touchPointIt ) {
 				glLineWidth( 1.0f );
 				gl::drawStrokedCircle( touchPointIt->getPos(), 25.0f );
 			}
@@ -190,7 +190,7 @@ namespace Pivot {
 	
 	void Renderer::drawPivot( TouchObject &touchObject )
 	{
-		TouchPivot touchPivot = touchObject.getTouchPivot();
+		const TouchPivot &touchPivot = touchObject.getTouchPivot();
 		
 		if ( touchPivot.isActive() ) {
 			gl::pushMatrices();
@@ -0,0 +1,438 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+#include <algorithm>
+#include <cfloat>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define PIVOT_STROKERECOGNIZER_SSE
+#endif
+
+#include "StrokeRecognizer.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	// fields span the normalized [-1, 1] square, and store distances in steps of 1 / kFieldScale
+	static const float kFieldScale = 128.0f;
+	// the weights 1 - k / kNumPoints of the k-th matched point add up to this
+	static const float kWeightSum = ( StrokeRecognizer::kNumPoints + 1 ) * 0.5f;
+	
+	StrokeRecognizer::StrokeRecognizer()
+	: mCandidateField( kFieldCells ), mMaxDistance( 0.06f ), mMinLength( 40.0f )
+	{}
+	
+	int StrokeRecognizer::addTemplate( const string &name, const vector<Vec2f> &points )
+	{
+		vector<RawPoint> rawPoints( points.size() );
+		for( size_t i = 0; i < points.size(); ++i ) {
+			rawPoints[i].mPos = points[i];
+			rawPoints[i].mStroke = 0;
+		}
+		
+		float xs[kNumPoints], ys[kNumPoints];
+		Vec2f center;
+		float size;
+		if ( ! normalize( rawPoints, 0.0f, xs, ys, &center, &size ) ) return -1;
+		return addNormalized( name, xs, ys );
+	}
+	
+	int StrokeRecognizer::addTemplate( const string &name, const vector<vector<Vec2f> > &strokes )
+	{
+		vector<RawPoint> rawPoints;
+		for( size_t stroke = 0; stroke < strokes.size(); ++stroke ) {
+			for( vector<Vec2f>::const_iterator it = strokes[stroke].begin(); it != strokes[stroke].end(); ++it ) {
+				RawPoint rawPoint;
+				rawPoint.mPos = *it;
+				rawPoint.mStroke = stroke;
+				rawPoints.push_back( rawPoint );
+			}
+		}
+		
+		float xs[kNumPoints], ys[kNumPoints];
+		Vec2f center;
+		float size;
+		if ( ! normalize( rawPoints, 0.0f, xs, ys, &center, &size ) ) return -1;
+		return addNormalized( name, xs, ys );
+	}
+	
+	int StrokeRecognizer::addRecordedTemplate( const string &name )
+	{
+		mSortedPoints = mRawPoints;
+		stable_sort( mSortedPoints.begin(), mSortedPoints.end() );
+		
+		float xs[kNumPoints], ys[kNumPoints];
+		Vec2f center;
+		float size;
+		if ( ! normalize( mSortedPoints, 0.0f, xs, ys, &center, &size ) ) return -1;
+		return addNormalized( name, xs, ys );
+	}
+	
+	void StrokeRecognizer::clear()
+	{
+		mNames.clear();
+		mPointsX.clear();
+		mPointsY.clear();
+		mPointCells.clear();
+		mFields.clear();
+	}
+	
+	void StrokeRecognizer::addPoint( uint32_t strokeId, const Vec2f &pos )
+	{
+		// a handful of strokes at most, so a linear search beats a map
+		int stroke = find( mStrokeIds.begin(), mStrokeIds.end(), strokeId ) - mStrokeIds.begin();
+		if ( stroke == int( mStrokeIds.size() ) ) mStrokeIds.push_back( strokeId );
+		
+		RawPoint rawPoint;
+		rawPoint.mPos = pos;
+		rawPoint.mStroke = stroke;
+		mRawPoints.push_back( rawPoint );
+	}
+	
+	void StrokeRecognizer::addPoints( const TouchPointSpan &touchPoints )
+	{
+		const TouchSample *samples = touchPoints.getSamples();
+		for( int i = 0; i < touchPoints.size(); ++i ) addPoint( samples[i].mId, samples[i].mPos );
+	}
+	
+	void StrokeRecognizer::clearPoints()
+	{
+		mRawPoints.clear();
+		mStrokeIds.clear();
+	}
+	
+	bool StrokeRecognizer::recognize( StrokeMatch *match )
+	{
+		if ( empty() || mRawPoints.size() < 2 ) return false;
+		
+		// touches interleave their points, so gather each stroke's points together first
+		mSortedPoints = mRawPoints;
+		stable_sort( mSortedPoints.begin(), mSortedPoints.end() );
+		
+		Vec2f center;
+		float size;
+		if ( ! normalize( mSortedPoints, mMinLength, mCandidateX, mCandidateY, &center, &size ) ) return false;
+		buildField( mCandidateX, mCandidateY, &mCandidateField[0], mCandidateCells );
+		
+		// order templates by lower bound, so the likeliest are matched first and the rest can be abandoned wholesale
+		float startBounds[2 * kNumStarts];
+		mOrder.clear();
+		for( int t = 0; t < numTemplates(); ++t ) mOrder.push_back( make_pair( calcTemplateBounds( t, startBounds ), t ) );
+		sort( mOrder.begin(), mOrder.end() );
+		
+		float best = mMaxDistance * kWeightSum;
+		int bestTemplate = -1;
+		for( vector<pair<float, int> >::const_iterator it = mOrder.begin(); it != mOrder.end(); ++it ) {
+			if ( it->first >= best ) break;
+			float distance = matchTemplate( it->second, best );
+			if ( distance < best ) {
+				best = distance;
+				bestTemplate = it->second;
+			}
+		}
+		if ( bestTemplate < 0 ) return false;
+		
+		match->mTemplate = bestTemplate;
+		match->mName = mNames[bestTemplate];
+		match->mDistance = best / kWeightSum;
+		match->mNumStrokes = mStrokeIds.size();
+		match->mCenter = center;
+		match->mSize = size;
+		return true;
+	}
+	
+	bool StrokeRecognizer::normalize( const vector<RawPoint> &points, float minLength, float *xs, float *ys, Vec2f *center, float *size )
+	{
+		if ( points.empty() ) return false;
+		
+		// jumps between strokes don't count towards the length
+		float length = 0.0f;
+		for( size_t i = 1; i < points.size(); ++i )
+			if ( points[i].mStroke == points[i - 1].mStroke ) length += points[i].mPos.distance( points[i - 1].mPos );
+		if ( length < math<float>::max( minLength, 1e-4f ) ) return false;
+		
+		// resample to kNumPoints evenly spaced along the strokes
+		float interval = length / ( kNumPoints - 1 );
+		float travelled = 0.0f;
+		Vec2f prev = points[0].mPos;
+		xs[0] = prev.x;
+		ys[0] = prev.y;
+		int count = 1;
+		for( size_t i = 1; i < points.size() && count < kNumPoints; ++i ) {
+			Vec2f pos = points[i].mPos;
+			if ( points[i].mStroke != points[i - 1].mStroke ) {
+				prev = pos;
+				continue;
+			}
+			
+			float dist = prev.distance( pos );
+			while( travelled + dist >= interval && count < kNumPoints ) {
+				prev += ( pos - prev ) * ( ( interval - travelled ) / dist );
+				xs[count] = prev.x;
+				ys[count] = prev.y;
+				++count;
+				dist = prev.distance( pos );
+				travelled = 0.0f;
+			}
+			travelled += dist;
+			prev = pos;
+		}
+		// rounding can leave the last point short
+		for( ; count < kNumPoints; ++count ) {
+			xs[count] = points.back().mPos.x;
+			ys[count] = points.back().mPos.y;
+		}
+		
+		// scale uniformly to a unit box, then center on the centroid
+		float minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+		float sumX = 0.0f, sumY = 0.0f;
+		for( int i = 0; i < kNumPoints; ++i ) {
+			minX = math<float>::min( minX, xs[i] );
+			maxX = math<float>::max( maxX, xs[i] );
+			minY = math<float>::min( minY, ys[i] );
+			maxY = math<float>::max( maxY, ys[i] );
+			sumX += xs[i];
+			sumY += ys[i];
+		}
+		*center = Vec2f( sumX, sumY ) / float( kNumPoints );
+		*size = math<float>::max( maxX - minX, maxY - minY );
+		
+		float scale = 1.0f / *size;
+		for( int i = 0; i < kNumPoints; ++i ) {
+			xs[i] = ( xs[i] - center->x ) * scale;
+			ys[i] = ( ys[i] - center->y ) * scale;
+		}
+		return true;
+	}
+	
+	int StrokeRecognizer::addNormalized( const string &name, const float *xs, const float *ys )
+	{
+		int t = mNames.size();
+		mNames.push_back( name );
+		mPointsX.insert( mPointsX.end(), xs, xs + kNumPoints );
+		mPointsY.insert( mPointsY.end(), ys, ys + kNumPoints );
+		mPointCells.resize( mPointCells.size() + kNumPoints );
+		mFields.resize( mFields.size() + kFieldCells );
+		buildField( xs, ys, &mFields[t * kFieldCells], &mPointCells[t * kNumPoints] );
+		return t;
+	}
+	
+	void StrokeRecognizer::buildField( const float *xs, const float *ys, uint8_t *field, uint16_t *cells )
+	{
+		// each cell stores the distance from the cell's square, not its center, to the nearest point, so it bounds every position in it
+		const float cellSize = 2.0f / kFieldSize;
+		float distSqY[kNumPoints];
+		for( int cellY = 0; cellY < kFieldSize; ++cellY ) {
+			float y0 = -1.0f + cellY * cellSize, y1 = y0 + cellSize;
+			for( int i = 0; i < kNumPoints; ++i ) {
+				float dy = math<float>::max( math<float>::max( y0 - ys[i], ys[i] - y1 ), 0.0f );
+				distSqY[i] = dy * dy;
+			}
+			
+			for( int cellX = 0; cellX < kFieldSize; ++cellX ) {
+				float x0 = -1.0f + cellX * cellSize, x1 = x0 + cellSize;
+				float minDistSq;
+#if defined( PIVOT_STROKERECOGNIZER_SSE )
+				__m128 left = _mm_set1_ps( x0 );
+				__m128 right = _mm_set1_ps( x1 );
+				__m128 zero = _mm_setzero_ps();
+				__m128 laneMin = _mm_set1_ps( FLT_MAX );
+				for( int i = 0; i < kNumPoints; i += 4 ) {
+					__m128 x = _mm_loadu_ps( &xs[i] );
+					__m128 dx = _mm_max_ps( _mm_max_ps( _mm_sub_ps( left, x ), _mm_sub_ps( x, right ) ), zero );
+					laneMin = _mm_min_ps( laneMin, _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_loadu_ps( &distSqY[i] ) ) );
+				}
+				float lanes[4];
+				_mm_storeu_ps( lanes, laneMin );
+				minDistSq = math<float>::min( math<float>::min( lanes[0], lanes[1] ), math<float>::min( lanes[2], lanes[3] ) );
+#else
+				minDistSq = FLT_MAX;
+				for( int i = 0; i < kNumPoints; ++i ) {
+					float dx = math<float>::max( math<float>::max( x0 - xs[i], xs[i] - x1 ), 0.0f );
+					minDistSq = math<float>::min( minDistSq, dx * dx + distSqY[i] );
+				}
+#endif
+				field[cellY * kFieldSize + cellX] = uint8_t( math<float>::min( math<float>::sqrt( minDistSq ) * kFieldScale, 255.0f ) );
+			}
+		}
+		
+		for( int i = 0; i < kNumPoints; ++i ) {
+			int cellX = math<int>::clamp( int( ( xs[i] + 1.0f ) / cellSize ), 0, kFieldSize - 1 );
+			int cellY = math<int>::clamp( int( ( ys[i] + 1.0f ) / cellSize ), 0, kFieldSize - 1 );
+			cells[i] = uint16_t( cellY * kFieldSize + cellX );
+		}
+	}
+	
+	void StrokeRecognizer::calcStartBounds( const float *pointBounds, float *startBounds )
+	{
+		// the weight of point i from start s is 1 - ( ( i - s ) mod n ) / n, so every start follows from two sums and a prefix sum
+		float sum = 0.0f, indexSum = 0.0f;
+		for( int i = 0; i < kNumPoints; ++i ) {
+			sum += pointBounds[i];
+			indexSum += i * pointBounds[i];
+		}
+		
+		float prefix = 0.0f;
+		int i = 0;
+		for( int k = 0; k < kNumStarts; ++k ) {
+			int start = k * kStartStep;
+			for( ; i < start; ++i ) prefix += pointBounds[i];
+			startBounds[k] = sum - ( indexSum - start * sum + kNumPoints * prefix ) / kNumPoints;
+		}
+	}
+	
+	float StrokeRecognizer::calcTemplateBounds( int t, float *startBounds ) const
+	{
+		// no point is nearer to the other cloud than its cell's field distance
+		const uint8_t *field = &mFields[t * kFieldCells];
+		const uint16_t *cells = &mPointCells[t * kNumPoints];
+		float candidateBounds[kNumPoints], templateBounds[kNumPoints];
+		for( int i = 0; i < kNumPoints; ++i ) {
+			candidateBounds[i] = field[mCandidateCells[i]] * ( 1.0f / kFieldScale );
+			templateBounds[i] = mCandidateField[cells[i]] * ( 1.0f / kFieldScale );
+		}
+		calcStartBounds( candidateBounds, startBounds );
+		calcStartBounds( templateBounds, startBounds + kNumStarts );
+		
+		return *min_element( startBounds, startBounds + 2 * kNumStarts );
+	}
+	
+	float StrokeRecognizer::matchTemplate( int t, float minSoFar ) const
+	{
+		// the field bounds got this far, so tighten them with each point's exact nearest distance before matching
+		const float *templateX = &mPointsX[t * kNumPoints];
+		const float *templateY = &mPointsY[t * kNumPoints];
+		float candidateBounds[kNumPoints], templateBounds[kNumPoints];
+		float startBounds[2 * kNumStarts];
+		calcNearestDistances( mCandidateX, mCandidateY, templateX, templateY, candidateBounds );
+		calcStartBounds( candidateBounds, startBounds );
+		calcNearestDistances( templateX, templateY, mCandidateX, mCandidateY, templateBounds );
+		calcStartBounds( templateBounds, startBounds + kNumStarts );
+		
+		for( int k = 0; k < kNumStarts; ++k ) {
+			if ( startBounds[k] < minSoFar )
+				minSoFar = math<float>::min( minSoFar, calcCloudDistance( mCandidateX, mCandidateY, templateX, templateY, k * kStartStep, minSoFar ) );
+			if ( startBounds[kNumStarts + k] < minSoFar )
+				minSoFar = math<float>::min( minSoFar, calcCloudDistance( templateX, templateY, mCandidateX, mCandidateY, k * kStartStep, minSoFar ) );
+		}
+		return minSoFar;
+	}
+	
+	void StrokeRecognizer::calcNearestDistances( const float *ax, const float *ay, const float *bx, const float *by, float *distances )
+	{
+		for( int i = 0; i < kNumPoints; ++i ) {
+			float minDistSq;
+#if defined( PIVOT_STROKERECOGNIZER_SSE )
+			__m128 px = _mm_set1_ps( ax[i] );
+			__m128 py = _mm_set1_ps( ay[i] );
+			__m128 laneMin = _mm_set1_ps( FLT_MAX );
+			for( int j = 0; j < kNumPoints; j += 4 ) {
+				__m128 dx = _mm_sub_ps( _mm_loadu_ps( &bx[j] ), px );
+				__m128 dy = _mm_sub_ps( _mm_loadu_ps( &by[j] ), py );
+				laneMin = _mm_min_ps( laneMin, _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ) );
+			}
+			float lanes[4];
+			_mm_storeu_ps( lanes, laneMin );
+			minDistSq = math<float>::min( math<float>::min( lanes[0], lanes[1] ), math<float>::min( lanes[2], lanes[3] ) );
+#else
+			minDistSq = FLT_MAX;
+			for( int j = 0; j < kNumPoints; ++j ) {
+				float dx = bx[j] - ax[i], dy = by[j] - ay[i];
+				minDistSq = math<float>::min( minDistSq, dx * dx + dy * dy );
+			}
+#endif
+			distances[i] = math<float>::sqrt( minDistSq );
+		}
+	}
+	
+	float StrokeRecognizer::calcCloudDistance( const float *ax, const float *ay, const float *bx, const float *by, int start, float minSoFar )
+	{
+		// matched points are pushed out of reach rather than skipped, so the search stays branch free
+		float matched[kNumPoints];
+		fill( matched, matched + kNumPoints, 0.0f );
+		
+		float sum = 0.0f;
+		int i = start;
+		for( int k = 0; k < kNumPoints; ++k ) {
+			float minDistSq;
+			int nearest;
+#if defined( PIVOT_STROKERECOGNIZER_SSE )
+			__m128 px = _mm_set1_ps( ax[i] );
+			__m128 py = _mm_set1_ps( ay[i] );
+			__m128 laneMin = _mm_set1_ps( FLT_MAX );
+			__m128i laneNearest = _mm_setzero_si128();
+			__m128i index = _mm_set_epi32( 3, 2, 1, 0 );
+			__m128i four = _mm_set1_epi32( 4 );
+			for( int j = 0; j < kNumPoints; j += 4 ) {
+				__m128 dx = _mm_sub_ps( _mm_loadu_ps( &bx[j] ), px );
+				__m128 dy = _mm_sub_ps( _mm_loadu_ps( &by[j] ), py );
+				__m128 distSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_loadu_ps( &matched[j] ) );
+				__m128i closer = _mm_castps_si128( _mm_cmplt_ps( distSq, laneMin ) );
+				laneMin = _mm_min_ps( distSq, laneMin );
+				laneNearest = _mm_or_si128( _mm_and_si128( closer, index ), _mm_andnot_si128( closer, laneNearest ) );
+				index = _mm_add_epi32( index, four );
+			}
+			
+			float lanes[4];
+			int laneIndices[4];
+			_mm_storeu_ps( lanes, laneMin );
+			_mm_storeu_si128( (__m128i*)laneIndices, laneNearest );
+			minDistSq = lanes[0];
+			nearest = laneIndices[0];
+			for( int lane = 1; lane < 4; ++lane ) {
+				if ( lanes[lane] < minDistSq ) {
+					minDistSq = lanes[lane];
+					nearest = laneIndices[lane];
+				}
+			}
+#else
+			minDistSq = FLT_MAX;
+			nearest = 0;
+			for( int j = 0; j < kNumPoints; ++j ) {
+				float dx = bx[j] - ax[i], dy = by[j] - ay[i];
+				float distSq = dx * dx + dy * dy + matched[j];
+				if ( distSq < minDistSq ) {
+					minDistSq = distSq;
+					nearest = j;
+				}
+			}
+#endif
+			
+			sum += ( 1.0f - float( k ) / kNumPoints ) * math<float>::sqrt( minDistSq );
+			if ( sum >= minSoFar ) return sum;
+			
+			matched[nearest] = FLT_MAX;
+			i = ( i + 1 ) % kNumPoints;
+		}
+		return sum;
+	}
+	
+}
@@ -0,0 +1,228 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#include "TouchClusterer.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	TouchClusterer::TouchClusterer( float linkDistance, float rejoinTime )
+	: mNextCluster( 0 ), mLinkDistance( linkDistance ), mRejoinTime( rejoinTime )
+	{}
+	
+	void TouchClusterer::touchesBegan( const TouchList &touches )
+	{
+		if ( touches.empty() ) return;
+		
+		int numOld = mNodes.size();
+		for( TouchList::const_iterator it = touches.begin(); it != touches.end(); ++it ) {
+			if ( mNodeIndices.find( it->getId() ) != mNodeIndices.end() ) continue;
+			Node node;
+			node.mId = it->getId();
+			node.mPos = it->getPos();
+			node.mCluster = -1;
+			mNodeIndices[node.mId] = mNodes.size();
+			mNodes.push_back( node );
+		}
+		int numNodes = mNodes.size();
+		int numNew = numNodes - numOld;
+		if ( numNew == 0 ) return;
+		
+		// forget lifted hands already taken back or too old to rejoin
+		double time = touches.front().getTime();
+		vector<LiftedCluster>::iterator liftedIt = mLiftedClusters.begin();
+		while( liftedIt != mLiftedClusters.end() ) {
+			if ( liftedIt->mCluster < 0 || time - liftedIt->mTime > mRejoinTime ) liftedIt = mLiftedClusters.erase( liftedIt );
+			else ++liftedIt;
+		}
+		
+		buildGrid( numNodes );
+		
+		mParents.resize( numNew );
+		mJoinClusters.assign( numNew, -1 );
+		mJoinDistSq.assign( numNew, mLinkDistance * mLinkDistance );
+		for( int i = 0; i < numNew; ++i )
+			mParents[i] = i;
+		
+		// each new touch only looks through its 3x3 block of link-sized cells: union with new neighbors, remember the nearest old one
+		float invCellSize = 1.0f / mLinkDistance;
+		float linkDistSq = mLinkDistance * mLinkDistance;
+		for( int i = 0; i < numNew; ++i ) {
+			const Vec2f &pos = mNodes[numOld + i].mPos;
+			int cellX = int( floorf( pos.x * invCellSize ) );
+			int cellY = int( floorf( pos.y * invCellSize ) );
+			for( int y = cellY - 1; y <= cellY + 1; ++y ) {
+				for( int x = cellX - 1; x <= cellX + 1; ++x ) {
+					for( int j = mBuckets[findBucket( x, y )]; j >= 0; j = mNodes[j].mNext ) {
+						float distSq = mNodes[j].mPos.distanceSquared( pos );
+						if ( distSq > linkDistSq ) continue;
+						if ( j < numOld ) {
+							if ( distSq <= mJoinDistSq[i] ) {
+								mJoinDistSq[i] = distSq;
+								mJoinClusters[i] = mNodes[j].mCluster;
+							}
+						} else if ( j - numOld != i ) {
+							mParents[findRoot( i )] = findRoot( j - numOld );
+						}
+					}
+				}
+			}
+		}
+		
+		// a group of new touches joins the old hand nearest to any of them, held on the root
+		for( int i = 0; i < numNew; ++i ) {
+			int root = findRoot( i );
+			if ( root != i && mJoinClusters[i] >= 0 && ( mJoinClusters[root] < 0 || mJoinDistSq[i] < mJoinDistSq[root] ) ) {
+				mJoinClusters[root] = mJoinClusters[i];
+				mJoinDistSq[root] = mJoinDistSq[i];
+			}
+		}
+		
+		// otherwise it takes back the hand that lifted nearest to any of its touches, or starts a new one
+		mRejoinIndices.assign( numNew, -1 );
+		for( int i = 0; i < numNew; ++i ) {
+			int root = findRoot( i );
+			if ( mJoinClusters[root] >= 0 ) continue;
+			for( size_t j = 0; j < mLiftedClusters.size(); ++j ) {
+				float distSq = mLiftedClusters[j].mPos.distanceSquared( mNodes[numOld + i].mPos );
+				if ( distSq <= mJoinDistSq[root] ) {
+					mJoinDistSq[root] = distSq;
+					mRejoinIndices[root] = j;
+				}
+			}
+		}
+		for( int i = 0; i < numNew; ++i ) {
+			if ( findRoot( i ) != i || mJoinClusters[i] >= 0 ) continue;
+			int lifted = mRejoinIndices[i];
+			if ( lifted >= 0 && mLiftedClusters[lifted].mCluster >= 0 ) {
+				mJoinClusters[i] = mLiftedClusters[lifted].mCluster;
+				mLiftedClusters[lifted].mCluster = -1;
+			} else {
+				mJoinClusters[i] = mNextCluster++;
+			}
+		}
+		
+		for( int i = 0; i < numNew; ++i ) {
+			int cluster = mJoinClusters[findRoot( i )];
+			mNodes[numOld + i].mCluster = cluster;
+			++mClusterSizes[cluster];
+		}
+	}
+	
+	void TouchClusterer::touchesMoved( const TouchList &touches )
+	{
+		for( TouchList::const_iterator it = touches.begin(); it != touches.end(); ++it ) {
+			boost::unordered_map<uint32_t, int>::const_iterator found = mNodeIndices.find( it->getId() );
+			if ( found != mNodeIndices.end() ) mNodes[found->second].mPos = it->getPos();
+		}
+	}
+	
+	void TouchClusterer::touchesEnded( const TouchList &touches )
+	{
+		for( TouchList::const_iterator it = touches.begin(); it != touches.end(); ++it ) {
+			boost::unordered_map<uint32_t, int>::iterator found = mNodeIndices.find( it->getId() );
+			if ( found == mNodeIndices.end() ) continue;
+			
+			int index = found->second;
+			int cluster = mNodes[index].mCluster;
+			mNodeIndices.erase( found );
+			if ( --mClusterSizes[cluster] == 0 ) {
+				mClusterSizes.erase( cluster );
+				LiftedCluster lifted;
+				lifted.mCluster = cluster;
+				lifted.mPos = it->getPos();
+				lifted.mTime = it->getTime();
+				mLiftedClusters.push_back( lifted );
+			}
+			
+			// swap the last node into the hole
+			if ( index != int( mNodes.size() ) - 1 ) {
+				mNodes[index] = mNodes.back();
+				mNodeIndices[mNodes[index].mId] = index;
+			}
+			mNodes.pop_back();
+		}
+	}
+	
+	void TouchClusterer::clear()
+	{
+		mNodes.clear();
+		mNodeIndices.clear();
+		mClusterSizes.clear();
+		mLiftedClusters.clear();
+	}
+	
+	int TouchClusterer::getCluster( uint32_t touchId ) const
+	{
+		boost::unordered_map<uint32_t, int>::const_iterator found = mNodeIndices.find( touchId );
+		return ( found != mNodeIndices.end() ) ? mNodes[found->second].mCluster : -1;
+	}
+	
+	int TouchClusterer::getClusterSize( int cluster ) const
+	{
+		boost::unordered_map<int, int>::const_iterator found = mClusterSizes.find( cluster );
+		return ( found != mClusterSizes.end() ) ? found->second : 0;
+	}
+	
+	void TouchClusterer::buildGrid( int numNodes )
+	{
+		// at least twice as many buckets as nodes, a power of two so hashing is a mask
+		int numBuckets = 16;
+		while( numBuckets < numNodes * 2 )
+			numBuckets *= 2;
+		mBuckets.assign( numBuckets, -1 );
+		
+		float invCellSize = 1.0f / mLinkDistance;
+		for( int i = 0; i < numNodes; ++i ) {
+			int bucket = findBucket( int( floorf( mNodes[i].mPos.x * invCellSize ) ), int( floorf( mNodes[i].mPos.y * invCellSize ) ) );
+			mNodes[i].mNext = mBuckets[bucket];
+			mBuckets[bucket] = i;
+		}
+	}
+	
+	int TouchClusterer::findBucket( int cellX, int cellY ) const
+	{
+		// cells sharing a bucket only cost extra distance checks
+		uint32_t hash = uint32_t( cellX ) * 73856093u ^ uint32_t( cellY ) * 19349663u;
+		return hash & ( mBuckets.size() - 1 );
+	}
+	
+	int TouchClusterer::findRoot( int node )
+	{
+		while( mParents[node] != node ) {
+			mParents[node] = mParents[mParents[node]];
+			node = mParents[node];
+		}
+		return node;
+	}
+	
+}
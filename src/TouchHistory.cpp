@@ -0,0 +1,118 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "TouchHistory.h"
+#include "VelocityEstimator.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	void TouchHistory::addSample( const TouchEvent::Touch &touch )
+	{
+		int index = findTrack( touch.getId() );
+		if ( index < 0 ) {
+			index = mTracks.size();
+			mTracks.resize( index + 1 );
+			mTracks[index].mId = touch.getId();
+			mTracks[index].mHead = 0;
+			mTracks[index].mCount = 0;
+		}
+		
+		Track &track = mTracks[index];
+		track.mHead = ( track.mHead + 1 ) % kCapacity;
+		track.mSamples[track.mHead] = TouchSample( touch.getPos(), touch.getId(), touch.getTime() );
+		if ( track.mCount < kCapacity ) ++track.mCount;
+	}
+	
+	void TouchHistory::removeTouch( uint32_t id )
+	{
+		int index = findTrack( id );
+		if ( index < 0 ) return;
+		
+		// order of tracks doesn't matter, so swap with the last one and keep the storage
+		if ( index != (int)mTracks.size() - 1 ) mTracks[index] = mTracks.back();
+		mTracks.pop_back();
+	}
+	
+	int TouchHistory::numSamples( uint32_t id ) const
+	{
+		int index = findTrack( id );
+		return ( index < 0 ) ? 0 : mTracks[index].mCount;
+	}
+	
+	TouchSample TouchHistory::getSample( uint32_t id, int age ) const
+	{
+		const Track &track = mTracks[findTrack( id )];
+		return track.mSamples[( track.mHead - age + kCapacity ) % kCapacity];
+	}
+	
+	Vec2f TouchHistory::resample( uint32_t id, double offset, double window ) const
+	{
+		int index = findTrack( id );
+		if ( index < 0 || mTracks[index].mCount == 0 ) return Vec2f::zero();
+		
+		const Track &track = mTracks[index];
+		const TouchSample &newest = track.mSamples[track.mHead];
+		
+		if ( offset < 0.0 ) {
+			// walk back to the pair of samples around the offset
+			for( int age = 1; age < track.mCount; ++age ) {
+				const TouchSample &older = track.mSamples[( track.mHead - age + kCapacity ) % kCapacity];
+				const TouchSample &newer = track.mSamples[( track.mHead - age + 1 + kCapacity ) % kCapacity];
+				double olderOffset = -( uint32_t( newest.mTicks - older.mTicks ) / double( TouchSample::kTicksPerSecond ) );
+				if ( olderOffset <= offset ) {
+					double newerOffset = -( uint32_t( newest.mTicks - newer.mTicks ) / double( TouchSample::kTicksPerSecond ) );
+					float u = ( newerOffset > olderOffset ) ? float( ( offset - olderOffset ) / ( newerOffset - olderOffset ) ) : 1.0f;
+					return older.mPos.lerp( u, newer.mPos );
+				}
+			}
+			// older than the history reaches
+			return track.mSamples[( track.mHead - track.mCount + 1 + kCapacity ) % kCapacity].mPos;
+		}
+		
+		VelocityEstimator velX( VelocityEstimator::LEAST_SQUARES, window ), velY( VelocityEstimator::LEAST_SQUARES, window );
+		for( int age = track.mCount - 1; age >= 0; --age ) {
+			const TouchSample &sample = track.mSamples[( track.mHead - age + kCapacity ) % kCapacity];
+			double time = -( uint32_t( newest.mTicks - sample.mTicks ) / double( TouchSample::kTicksPerSecond ) );
+			if ( time < -window ) continue;
+			velX.addSample( time, sample.mPos.x );
+			velY.addSample( time, sample.mPos.y );
+		}
+		return newest.mPos + Vec2f( velX.getVelocity(), velY.getVelocity() ) * offset;
+	}
+	
+	int TouchHistory::findTrack( uint32_t id ) const
+	{
+		for( size_t i = 0; i < mTracks.size(); ++i )
+			if ( mTracks[i].mId == id ) return i;
+		return -1;
+	}
+	
+}
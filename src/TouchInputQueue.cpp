@@ -0,0 +1,86 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "TouchInputQueue.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	TouchInputQueue::TouchInputQueue()
+	: mStaging( kCapacity ), mNumDropped( 0 )
+	{}
+	
+	bool TouchInputQueue::push( TouchPhase phase, const vector<TouchEvent::Touch> &touches )
+	{
+		return pushEvent( phase, touches, NULL );
+	}
+	
+	bool TouchInputQueue::push( TouchPhase phase, const vector<TouchEvent::Touch> &touches, double time )
+	{
+		return pushEvent( phase, touches, &time );
+	}
+	
+	bool TouchInputQueue::pushEvent( TouchPhase phase, const vector<TouchEvent::Touch> &touches, const double *time )
+	{
+		if ( touches.empty() ) return true;
+		
+		if ( mRecords.write_available() < touches.size() ) {
+			++mNumDropped;
+			return false;
+		}
+		
+		for( size_t i = 0; i < touches.size(); ++i ) {
+			const TouchEvent::Touch &touch = touches[i];
+			Record &record = mStaging[i];
+			// the native data belongs to the producer's event, which is gone by the time this is popped
+			record.mTouch = TouchEvent::Touch( touch.getPos(), touch.getPrevPos(), touch.getId(), time ? *time : touch.getTime(), NULL );
+			record.mPhase = phase;
+			record.mIsLastInEvent = ( i == touches.size() - 1 );
+		}
+		
+		// published with a single index update, so the consumer never sees half of an event
+		mRecords.push( &mStaging[0], touches.size() );
+		return true;
+	}
+	
+	bool TouchInputQueue::pop( TouchPhase *phase, vector<TouchEvent::Touch> *touches )
+	{
+		touches->clear();
+		
+		Record record;
+		while( mRecords.pop( record ) ) {
+			*phase = record.mPhase;
+			touches->push_back( record.mTouch );
+			if ( record.mIsLastInEvent ) return true;
+		}
+		return ! touches->empty();
+	}
+	
+}
@@ -30,7 +30,9 @@
 #include "cinder/Utilities.h"
 #include "cinder/gl/gl.h"
 
+#include "MomentumBatch.h"
 #include "TouchObject.h"
+#include "TouchScene.h"
 
 namespace Pivot {
 		
@@ -47,21 +49,48 @@ namespace Pivot {
 	
 	
 	
-	TouchObject3D::TouchObject3D( CameraPersp cam, bool captureTouches )
+	TouchObject3D::TouchObject3D( const CameraPersp &cam, bool captureTouches )
 	: TouchObject( captureTouches )
 	{
 		setCamera( cam );
 	}
 	
+	TouchObject3D::TouchObject3D( const CameraPersp &cam, const Vec2f &viewSize, bool captureTouches )
+	: TouchObject( captureTouches )
+	{
+		setCamera( cam, viewSize );
+	}
+	
+	void TouchObject3D::setCamera( const CameraPersp &cam )
+	{
+		if ( App::get() ) setCamera( cam, Vec2f( getWindowWidth(), getWindowHeight() ) );
+		else setCamera( cam, mProjection.getViewSize() );
+	}
+	
+	void TouchObject3D::setCamera( const CameraPersp &cam, const Vec2f &viewSize )
+	{
+		if ( mProjection.matches( cam, viewSize ) ) return;
+		mCam = cam;
+		mProjection = CameraSnapshot( cam, viewSize );
+		markBoundsDirty();
+	}
+	
 	
 
 	TouchObject::TouchObject()
 	{
 		enableCaptureMode();
 		
+		mSingleCluster = false;
+		mCluster = -1;
+		
 		mIsInMotion = false;
 		mVelDecay = 0.92f;
 		
+		mFixedStep = mStepAccumulator = 0.0f;
+		mStepAlpha = 1.0f;
+		mMaxSteps = 8;
+		
 		// debug color (for debug renderer)
 		setDebugColor( Color( CM_HSV, Rand::randFloat(), 1, 1 ) );
 	}
@@ -70,28 +99,100 @@ namespace Pivot {
 	{
 		enableCaptureMode( capturingTouches );
 		
+		mSingleCluster = false;
+		mCluster = -1;
+		
 		mIsInMotion = false;
 		mVelDecay = 0.92f;
 		
+		mFixedStep = mStepAccumulator = 0.0f;
+		mStepAlpha = 1.0f;
+		mMaxSteps = 8;
+		
 		setDebugColor( Color( CM_HSV, Rand::randFloat(), 1, 1 ) );
 	}
+	
+	TouchObject::~TouchObject()
+	{
+		if ( mSceneLink.mScene ) mSceneLink.mScene->removeObject( this );
+		if ( mMomentumLink.mBatch ) mMomentumLink.mBatch->removeObject( this );
+	}
+	
+	TouchObject::SceneLink& TouchObject::SceneLink::operator=( const SceneLink &other )
+	{
+		// keep this instance's scene membership, but its bounds were just overwritten
+		if ( mScene ) mScene->markBoundsDirty( mOwner );
+		return *this;
+	}
+	
+	void TouchObject::update( float deltaTime )
+	{
+		if ( ! mGestureEngine.empty() ) {
+			mGestureEngine->update( mTouchPivot.getTouchClock()->getCurrentTime() );
+			dispatchGestures();
+		}
+		
+		// integrated along with the rest of its MomentumBatch instead
+		if ( mMomentumLink.mBatch ) return;
+		
+		if ( ! isFixedTimestep() ) {
+			integrate( deltaTime );
+			return;
+		}
+		
+		mStepAccumulator += deltaTime;
+		int steps = 0;
+		while( mStepAccumulator >= mFixedStep && steps < mMaxSteps ) {
+			storePrevPose();
+			integrate( mFixedStep );
+			mStepAccumulator -= mFixedStep;
+			++steps;
+		}
+		
+		// after a hitch, drop whatever couldn't be caught up rather than spending the next frames on it
+		if ( mStepAccumulator >= mFixedStep ) mStepAccumulator = fmodf( mStepAccumulator, mFixedStep );
+		mStepAlpha = mStepAccumulator / mFixedStep;
+	}
+	
+	void TouchObject::enableFixedTimestep( float stepsPerSecond, int maxSteps )
+	{
+		// a MomentumBatch steps its members once per update, leaving nothing to blend
+		if ( mMomentumLink.mBatch ) return;
+		
+		mFixedStep = 1.0f / stepsPerSecond;
+		mMaxSteps = math<int>::max( maxSteps, 1 );
+		mStepAccumulator = 0.0f;
+		mStepAlpha = 1.0f;
+		storePrevPose();
+	}
+	
+	void TouchObject::setVelDecay( float velDecay )
+	{
+		fetchMomentum();
+		mVelDecay = velDecay;
+		if ( mMomentumLink.mBatch ) mMomentumLink.mBatch->wake( this );
+	}
+	
+	void TouchObject::fetchMomentum()
+	{
+		if ( mMomentumLink.mBatch ) mMomentumLink.mBatch->storeVelocities( this );
+	}
+	
+	void TouchObject::markBoundsDirty()
+	{
+		if ( mSceneLink.mScene ) mSceneLink.mScene->markBoundsDirty( this );
+	}
 
 	void TouchObject::touchesBegan( TouchList *touches )
 	{
-		bool isPivotReset;
-		
-		if ( mTouchPoints.size() == 0 ) isPivotReset = false;
-		else isPivotReset = true;
+		bool isPivotReset = ! mTouchPoints.empty();
+		TouchPointSet changedTouchPoints;
 		
 		// test if touch within interactive zone
-		list<TouchEvent::Touch>::iterator touchIt;
-		list<TouchPoint> changedTouchPoints;
-		
-		touchIt = touches->begin();
+		TouchList::iterator touchIt = touches->begin();
 		while( touchIt != touches->end() ) {
 			if( hitTest( *touchIt ) ) {
-				mTouchPoints.push_back( TouchPoint( touchIt->getPos(), touchIt->getPos(), touchIt->getPos(), touchIt->getId(), touchIt->getTime(), touchIt->getNative() ) );
-				changedTouchPoints.push_back( mTouchPoints.back() );
+				addTouchPoint( *touchIt, &changedTouchPoints );
 				if( mCapturingTouches ) touchIt = touches->erase(touchIt);
 				else ++touchIt;
 			} else {
@@ -99,162 +200,282 @@ namespace Pivot {
 			}
 		}
 		
-		if ( changedTouchPoints.size() > 0 ) {
-			mTouchPivot.touchPointsBegan( &mTouchPoints, &changedTouchPoints );
-			touchPointsBegan( &mTouchPoints, &changedTouchPoints, &mTouchPivot );
+		beginTouchPoints( changedTouchPoints, isPivotReset );
+	}
+	
+	void TouchObject::acceptTouches( const vector<TouchEvent::Touch> &touches )
+	{
+		bool isPivotReset = ! mTouchPoints.empty();
+		TouchPointSet changedTouchPoints;
+		
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt )
+			addTouchPoint( *touchIt, &changedTouchPoints );
+		
+		beginTouchPoints( changedTouchPoints, isPivotReset );
+	}
+	
+	void TouchObject::beginTouchPoints( const TouchPointSet &changedTouchPoints, bool isPivotReset )
+	{
+		if ( ! changedTouchPoints.empty() ) {
+			fetchMomentum();
+			mTouchPivot.touchPointsBegan( mTouchPoints.getSpan(), changedTouchPoints.getSpan() );
+			touchPointsBegan( mTouchPoints.getSpan(), changedTouchPoints.getSpan(), &mTouchPivot );
 			if (isPivotReset) pivotReset( &mTouchPivot );
 			else pivotBegan( &mTouchPivot );
+			touchPoseChanged();
+			
+			if ( ! mStrokeRecognizer.empty() ) {
+				if ( ! isPivotReset ) mStrokeRecognizer->clearPoints();
+				mStrokeRecognizer->addPoints( changedTouchPoints.getSpan() );
+			}
+			
+			if ( ! mGestureSpotter.empty() ) {
+				mGestureSpotter->touchesBegan( changedTouchPoints.getSpan() );
+				dispatchSpottedGestures();
+			}
+			
+			if ( ! mGestureEngine.empty() ) {
+				mGestureEngine->touchesBegan( mTouchPoints.size(), calcCentroid( mTouchPoints.getSpan(), TouchPointSpan() ), mTouchPivot.getTouchClock()->getTime( changedTouchPoints.getSpan() ) );
+				dispatchGestures();
+			}
 		}
 	}
 
 	void TouchObject::touchesMoved( TouchList *touches )
 	{
-		// test for existing touch and remove from both lists
-		list<TouchPoint>::iterator mTouchPointIt;
-		list<TouchEvent::Touch>::iterator touchIt;
-		list<TouchPoint> changedTouchPoints;
-		
-		mTouchPointIt = mTouchPoints.begin();
-		while( mTouchPointIt != mTouchPoints.end() ) {
-			touchIt = touches->begin();
-			while( touchIt != touches->end() ) {
-				if( touchIt->getId() == mTouchPointIt->getId() ) {
-					mTouchPointIt->setPrevPos( touchIt->getPrevPos() );
-					mTouchPointIt->setPos( touchIt->getPos() );
-					mTouchPointIt->setPrevTime( mTouchPointIt->getTime() );
-					mTouchPointIt->setTime( touchIt->getTime() );
-					changedTouchPoints.push_back( *mTouchPointIt );
-					if( mCapturingTouches ) touchIt = touches->erase( touchIt );
-					else ++touchIt;
-				} else {
-					++touchIt;
-				}
-			}
-			++mTouchPointIt;
+		TouchPointSet changedTouchPoints;
+		
+		TouchList::iterator touchIt = touches->begin();
+		while( touchIt != touches->end() ) {
+			if( moveTouchPoint( *touchIt, &changedTouchPoints ) && mCapturingTouches ) touchIt = touches->erase( touchIt );
+			else ++touchIt;
 		}
 		
-		if ( changedTouchPoints.size() > 0 ) {
-			bool changed = mTouchPivot.touchPointsMoved( &mTouchPoints, &changedTouchPoints );
+		moveTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::moveTouches( const vector<TouchEvent::Touch> &touches )
+	{
+		TouchPointSet changedTouchPoints;
+		
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt )
+			moveTouchPoint( *touchIt, &changedTouchPoints );
+		
+		moveTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::moveTouchPoints( const TouchPointSet &changedTouchPoints )
+	{
+		if ( ! changedTouchPoints.empty() ) {
+			bool changed = mTouchPivot.touchPointsMoved( mTouchPoints.getSpan(), changedTouchPoints.getSpan() );
 			if ( changed ) {
                 // TODO: If capture mode is DRAG, remove any newly captured touches from TouchList and return a list of cancelled touches
-				touchPointsMoved( &mTouchPoints, &changedTouchPoints, &mTouchPivot );
+				touchPointsMoved( mTouchPoints.getSpan(), changedTouchPoints.getSpan(), &mTouchPivot );
 				if ( mTouchPivot.isDragging() ) pivotMoved( &mTouchPivot );
+				touchPoseChanged();
+			}
+			
+			if ( ! mStrokeRecognizer.empty() ) mStrokeRecognizer->addPoints( changedTouchPoints.getSpan() );
+			
+			if ( ! mGestureSpotter.empty() ) {
+				mGestureSpotter->touchesMoved( changedTouchPoints.getSpan() );
+				dispatchSpottedGestures();
+			}
+			
+			if ( ! mChordClassifier.empty() ) {
+				Chord chord;
+				mChordClassifier->classify( mTouchPoints.getSpan(), &chord );
+				chordClassified( chord );
+			}
+			
+			if ( ! mGestureEngine.empty() ) {
+				mGestureEngine->touchesMoved( mTouchPoints.size(), calcCentroid( mTouchPoints.getSpan(), TouchPointSpan() ), mTouchPivot.getTouchClock()->getTime( changedTouchPoints.getSpan() ) );
+				dispatchGestures();
 			}
 		}
 	}
 
 	void TouchObject::touchesEnded( TouchList *touches )
 	{
-		// test for existing touch and remove from both lists
-		list<TouchPoint>::iterator touchPointIt;
-		list<TouchEvent::Touch>::iterator touchIt;
-		list<TouchPoint> changedTouchPoints;
+		TouchPointSet changedTouchPoints;
 		
-		touchPointIt = mTouchPoints.begin();
-		while( touchPointIt != mTouchPoints.end() ) {
-			
-			touchIt = touches->begin();
-			while( touchIt != touches->end() ) {
-				
-				if( touchPointIt != mTouchPoints.end() && touchIt->getId() == touchPointIt->getId() ) {
-					
-					touchPointIt->setPrevPos( touchIt->getPrevPos() );
-					touchPointIt->setPos( touchIt->getPos() );
-					touchPointIt->setPrevTime( touchPointIt->getTime() );
-					touchPointIt->setTime( touchIt->getTime() );
-					
-					changedTouchPoints.push_back( *touchPointIt );
-					touchPointIt = mTouchPoints.erase( touchPointIt );
-					if ( ! mTouchPoints.empty() ) --touchPointIt;
-					if( mCapturingTouches ) touchIt = touches->erase( touchIt );
-					else ++touchIt;
-
-				} else {
-					++touchIt;
-				}
-			}
-
-			if ( ! mTouchPoints.empty() ) ++touchPointIt;
+		TouchList::iterator touchIt = touches->begin();
+		while( touchIt != touches->end() ) {
+			if( removeTouchPoint( *touchIt, &changedTouchPoints ) && mCapturingTouches ) touchIt = touches->erase( touchIt );
+			else ++touchIt;
 		}
 		
-		if ( changedTouchPoints.size() > 0 ) {
-			mTouchPivot.touchPointsEnded( &mTouchPoints, &changedTouchPoints );
-			touchPointsEnded( &mTouchPoints, &changedTouchPoints, &mTouchPivot );
-			if ( mTouchPoints.size() == 0 ) pivotEnded( &mTouchPivot );
+		endTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::endTouches( const vector<TouchEvent::Touch> &touches )
+	{
+		TouchPointSet changedTouchPoints;
+		
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt )
+			removeTouchPoint( *touchIt, &changedTouchPoints );
+		
+		endTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::endTouchPoints( const TouchPointSet &changedTouchPoints )
+	{
+		if ( ! changedTouchPoints.empty() ) {
+			mTouchPivot.touchPointsEnded( mTouchPoints.getSpan(), changedTouchPoints.getSpan() );
+			touchPointsEnded( mTouchPoints.getSpan(), changedTouchPoints.getSpan(), &mTouchPivot );
+			if ( mTouchPoints.empty() ) pivotEnded( &mTouchPivot );
 			else pivotReset( &mTouchPivot );
+			touchPoseChanged();
+			if ( mTouchPoints.empty() ) mCluster = -1;
+			
+			if ( ! mStrokeRecognizer.empty() ) {
+				mStrokeRecognizer->addPoints( changedTouchPoints.getSpan() );
+				if ( mTouchPoints.empty() ) {
+					StrokeMatch match;
+					if ( mStrokeRecognizer->recognize( &match ) ) strokeRecognized( match );
+					mStrokeRecognizer->clearPoints();
+				}
+			}
+			
+			if ( ! mGestureSpotter.empty() ) {
+				mGestureSpotter->touchesEnded( changedTouchPoints.getSpan() );
+				dispatchSpottedGestures();
+			}
+			
+			if ( ! mGestureEngine.empty() ) {
+				mGestureEngine->touchesEnded( mTouchPoints.size(), calcCentroid( mTouchPoints.getSpan(), changedTouchPoints.getSpan() ), mTouchPivot.getTouchClock()->getTime( changedTouchPoints.getSpan() ) );
+				dispatchGestures();
+			}
 		}
 	}
 
 	void TouchObject::touchesCancelled( TouchList *touches )
 	{
-		// test for existing touch and remove from both lists
-		list<TouchPoint>::iterator touchPointIt;
-		list<TouchEvent::Touch>::iterator touchIt;
-		list<TouchPoint> changedTouchPoints;
-		
-		touchPointIt = mTouchPoints.begin();
-		while( touchPointIt != mTouchPoints.end() ) {
-			touchIt = touches->begin();
-			while( touchIt != touches->end() ) {
-				if( touchPointIt != mTouchPoints.end() && touchIt->getId() == touchPointIt->getId() ) {
-                    
-                    touchPointIt->setPrevPos( touchIt->getPrevPos() );
-					touchPointIt->setPos( touchIt->getPos() );
-					touchPointIt->setPrevTime( touchPointIt->getTime() );
-					touchPointIt->setTime( touchIt->getTime() );
-                    
-					changedTouchPoints.push_back( *touchPointIt );
-					touchPointIt = mTouchPoints.erase( touchPointIt );
-					if ( ! mTouchPoints.empty() ) --touchPointIt;
-					if( mCapturingTouches ) touchIt = touches->erase( touchIt );
-					else ++touchIt;
-				} else {
-					++touchIt;
-				}
-			}
-			if ( ! mTouchPoints.empty() ) ++touchPointIt;
-		}
+		TouchPointSet changedTouchPoints;
 		
-		if ( changedTouchPoints.size() > 0 ) {
-			mTouchPivot.touchPointsCancelled( &mTouchPoints, &changedTouchPoints );
-			touchPointsCancelled( &mTouchPoints, &changedTouchPoints, &mTouchPivot );
-			pivotCancelled( &mTouchPivot );
+		TouchList::iterator touchIt = touches->begin();
+		while( touchIt != touches->end() ) {
+			if( removeTouchPoint( *touchIt, &changedTouchPoints ) && mCapturingTouches ) touchIt = touches->erase( touchIt );
+			else ++touchIt;
 		}
+		
+		cancelTouchPoints( changedTouchPoints );
 	}
-
-	void TouchObject::touchesCancelled( list<TouchPoint> *touchPoints )
-	{
-		// test for existing touch and remove from both lists
-		list<TouchPoint>::iterator mTouchPointIt;
-		list<TouchPoint>::iterator touchPointIt;
-		list<TouchPoint> changedTouchPoints;
-		
-		touchPointIt = mTouchPoints.begin();
-		while( mTouchPointIt != mTouchPoints.end() ) {
-			touchPointIt = touchPoints->begin();
-			while( touchPointIt != touchPoints->end() ) {
-				if( touchPointIt->getId() == mTouchPointIt->getId() ) {
-					changedTouchPoints.push_back( *mTouchPointIt );
-					mTouchPointIt = mTouchPoints.erase( mTouchPointIt );
-					--mTouchPointIt;
-					if( mCapturingTouches ) touchPointIt = touchPoints->erase( touchPointIt );
-					else ++touchPointIt;
-				} else {
-					++touchPointIt;
-				}
+	
+	void TouchObject::cancelTouches( const vector<TouchEvent::Touch> &touches )
+	{
+		TouchPointSet changedTouchPoints;
+		
+		for( vector<TouchEvent::Touch>::const_iterator touchIt = touches.begin(); touchIt != touches.end(); ++touchIt )
+			removeTouchPoint( *touchIt, &changedTouchPoints );
+		
+		cancelTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::touchesCancelled( TouchPointSet *touchPoints )
+	{
+		TouchPointSet changedTouchPoints;
+		
+		int i = 0;
+		while( i < touchPoints->size() ) {
+			int slot = mTouchPoints.find( (*touchPoints)[i].getId() );
+			if( slot >= 0 ) {
+				changedTouchPoints.push_back( mTouchPoints[slot] );
+				mTouchPoints.erase( slot );
+				if( mCapturingTouches ) touchPoints->erase( i );
+				else ++i;
+			} else {
+				++i;
 			}
-			++mTouchPointIt;
 		}
 		
-		if ( changedTouchPoints.size() > 0 ) {
-			mTouchPivot.touchPointsCancelled( &mTouchPoints, &changedTouchPoints );
-			touchPointsCancelled( &mTouchPoints, &changedTouchPoints, &mTouchPivot );
+		cancelTouchPoints( changedTouchPoints );
+	}
+	
+	void TouchObject::cancelTouchPoints( const TouchPointSet &changedTouchPoints )
+	{
+		if ( ! changedTouchPoints.empty() ) {
+			mTouchPivot.touchPointsCancelled( mTouchPoints.getSpan(), changedTouchPoints.getSpan() );
+			touchPointsCancelled( mTouchPoints.getSpan(), changedTouchPoints.getSpan(), &mTouchPivot );
 			pivotCancelled( &mTouchPivot );
+			touchPoseChanged();
+			
+			if ( mTouchPoints.empty() ) {
+				if ( mStrokeRecognizer.isAllocated() ) mStrokeRecognizer->clearPoints();
+				mCluster = -1;
+			}
+			if ( ! mGestureSpotter.empty() ) mGestureSpotter->touchesCancelled( changedTouchPoints.getSpan() );
+			
+			if ( ! mGestureEngine.empty() ) {
+				mGestureEngine->touchesCancelled( mTouchPoints.size(), mTouchPivot.getTouchClock()->getTime( changedTouchPoints.getSpan() ) );
+				dispatchGestures();
+			}
 		}
 	}
 	
+	bool TouchObject::acceptsCluster( int cluster )
+	{
+		if ( ! mSingleCluster || cluster < 0 ) return true;
+		if ( mCluster < 0 ) mCluster = cluster;
+		return cluster == mCluster;
+	}
+	
+	void TouchObject::touchPoseChanged()
+	{
+		// touch-driven poses are shown as is, not blended with the last fixed step
+		if ( isFixedTimestep() ) storePrevPose();
+		// a release may have set this in motion
+		if ( mMomentumLink.mBatch ) mMomentumLink.mBatch->wake( this );
+	}
+	
+	void TouchObject::dispatchGestures()
+	{
+		Gesture gesture;
+		while( mGestureEngine->popGesture( &gesture ) ) gestureRecognized( gesture );
+	}
+	
+	void TouchObject::dispatchSpottedGestures()
+	{
+		SpottedGesture gesture;
+		while( mGestureSpotter->popGesture( &gesture ) ) gestureSpotted( gesture );
+	}
+	
+	Vec2f TouchObject::calcCentroid( const TouchPointSpan &touchPoints, const TouchPointSpan &moreTouchPoints )
+	{
+		int count = touchPoints.size() + moreTouchPoints.size();
+		if ( count == 0 ) return Vec2f::zero();
+		
+		Vec2f sum = Vec2f::zero();
+		for( int i = 0; i < touchPoints.size(); ++i ) sum += touchPoints.getSamples()[i].mPos;
+		for( int i = 0; i < moreTouchPoints.size(); ++i ) sum += moreTouchPoints.getSamples()[i].mPos;
+		return sum / float( count );
+	}
+	
+	void TouchObject::addTouchPoint( const TouchEvent::Touch &touch, TouchPointSet *addedTouchPoints )
+	{
+		mTouchPoints.push_back( TouchPoint( touch.getPos(), touch.getPos(), touch.getPos(), touch.getId(), touch.getTime(), touch.getNative() ) );
+		addedTouchPoints->push_back( mTouchPoints.back() );
+	}
+	
+	bool TouchObject::moveTouchPoint( const TouchEvent::Touch &touch, TouchPointSet *changedTouchPoints )
+	{
+		int slot = mTouchPoints.find( touch.getId() );
+		if ( slot < 0 ) return false;
+		
+		mTouchPoints.move( slot, touch.getPos(), touch.getPrevPos(), touch.getTime() );
+		changedTouchPoints->push_back( mTouchPoints[slot] );
+		return true;
+	}
+	
+	bool TouchObject::removeTouchPoint( const TouchEvent::Touch &touch, TouchPointSet *removedTouchPoints )
+	{
+		int slot = mTouchPoints.find( touch.getId() );
+		if ( slot < 0 ) return false;
+		
+		mTouchPoints.move( slot, touch.getPos(), touch.getPrevPos(), touch.getTime() );
+		removedTouchPoints->push_back( mTouchPoints[slot] );
+		mTouchPoints.erase( slot );
+		return true;
+	}
 	
 }
-
-
-
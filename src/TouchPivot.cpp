@@ -36,10 +36,15 @@ namespace Pivot {
 	using namespace ci::app;
 	using namespace std;
 	
-	TouchPivot::TouchPivot()
+	TouchPivot::TouchPivot( int transforms )
 	{
+		mTransforms = transforms;
 		mIsActive = mIsDragging = false;
 		mNumTouchPoints = 0;
+		mTouchHistory = NULL;
+		mTouchClock = TouchClock::getDefault();
+		mIsVelocityEstimated = false;
+		mIsFiltered = false;
 		
 		// init values and velocities
 		mPos = mResetPos = mReleasePosVel = Vec2f::zero();
@@ -51,6 +56,8 @@ namespace Pivot {
 		
 		// these help calculate pivot rotation and scale
 		mNode1 = mResetNode1 = mNode2 = mResetNode2 = Vec2f::zero();
+		mFitSumX = mFitSumY = mFitDot = mFitCross = mFitResetSpread = 0.0;
+		mNumFitNodes = 0;
 		
 		
 		// BEHAVIORAL PRESETS //////////////////////////////////////////////////
@@ -89,34 +96,27 @@ namespace Pivot {
 	}
 	
 	
-	void TouchPivot::touchPointsBegan( list<TouchPoint> *currentTouchPoints, list<TouchPoint> *addedTouchPoints )
+	void TouchPivot::touchPointsBegan( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &addedTouchPoints )
 	{
-		mNumTouchPoints = currentTouchPoints->size();
+		mNumTouchPoints = currentTouchPoints.size();
 		
-		Vec2f compositePos;
-		for (list<TouchPoint>::iterator it = currentTouchPoints->begin(); it != currentTouchPoints->end(); ++it) {
-			if ( it == currentTouchPoints->begin() ) compositePos = it->getPos();
-			compositePos = ( compositePos + it->getPos() ) / 2;
-		}
+		resetFit( currentTouchPoints );
+		Vec2f compositePos = calcCompositePos( currentTouchPoints );
 		
-		list<TouchPoint>::iterator touchPointsIt = currentTouchPoints->begin();
-		if ( mNumTouchPoints < 2 ) {
-			mNode1 = mResetNode1 = touchPointsIt->getPos();
-			mNode2 = mResetNode2 = touchPointsIt->getPos();
-		} else {
-			mNode1 = mResetNode1 = touchPointsIt->getPos();
-			mNode2 = mResetNode2 = (++touchPointsIt)->getPos();
-		}
+		const TouchSample *samples = currentTouchPoints.getSamples();
+		mNode1 = mResetNode1 = samples[0].mPos;
+		mNode2 = mResetNode2 = ( mNumTouchPoints < 2 ) ? samples[0].mPos : samples[1].mPos;
 		
 		// reset position/rotation/scale velocities
 		mReleasePosVel = Vec2f::zero();
 		mReleaseRotVel = 0.0f;
 		mReleaseScaleVel = 0.0f;
 		
-		// clear circular buffers
+		// clear velocity buffers
 		mPosAvgVel.clear();
 		mRotAvgVel.clear();
 		mScaleAvgVel.clear();
+		resetVelocityEstimators();
 		
 		// reset position/rotation/scale
 		mResetPos = mPos = compositePos;
@@ -126,30 +126,36 @@ namespace Pivot {
 		// check if active
 		if ( mIsActive ) {
 			mPrevTime = mTime;
-			mTime = getTime();
+			mTime = calcTime( addedTouchPoints );
 			mDeltaTimeAvg.push_back( mTime - mPrevTime );
 		} else {
 			mDeltaTimeAvg.clear();
-			mBeginTime = getElapsedSeconds();
+			mBeginTime = mTouchClock->getTime( addedTouchPoints );
 			mPrevTime = mTime = 0.0;
 			mIsDragging = false;
 			mIsActive = true;
 		}
+		
+		addVelocitySamples();
+		filterPose( true );
 	}
 
-	bool TouchPivot::touchPointsMoved( list<TouchPoint> *currentTouchPoints, list<TouchPoint> *changedTouchPoints )
+	bool TouchPivot::touchPointsMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints )
 	{
 		mPrevTime = mTime;
-		mTime = getTime();
+		mTime = calcTime( changedTouchPoints );
 		mDeltaTimeAvg.push_back( mTime - mPrevTime );
 		
-		mNumTouchPoints = currentTouchPoints->size();
+		mNumTouchPoints = currentTouchPoints.size();
 		
 		Vec2f p = mPos;
 		float r	= mRot;
 		float s = mScale;
 
-		setPivotMoved( currentTouchPoints );
+		setPivotMoved( currentTouchPoints, changedTouchPoints );
+		
+		addVelocitySamples();
+		filterPose( false );
 
 		bool changed;
 		if ( p != mPos || r != mRot || s != mScale ) changed = true;
@@ -164,55 +170,58 @@ namespace Pivot {
 	}
 	
 	
-	void TouchPivot::setPivotMoved( list<TouchPoint> *touchPoints )
+	void TouchPivot::setPivotMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints )
 	{
-		int num = touchPoints->size();
-		
-		Vec2f compositePos;
-		for (list<TouchPoint>::iterator it = touchPoints->begin(); it != touchPoints->end(); ++it) {
-			if ( it == touchPoints->begin() ) compositePos = it->getPos();
-			compositePos = ( compositePos + it->getPos() ) / 2;
+		switch( mTransforms & TRANSLATE_ROTATE_SCALE ) {
+			case TRANSLATE:	setPivotMoved<false, false>( currentTouchPoints, changedTouchPoints ); break;
+			case ROTATE:	setPivotMoved<true, false>( currentTouchPoints, changedTouchPoints ); break;
+			case SCALE:		setPivotMoved<false, true>( currentTouchPoints, changedTouchPoints ); break;
+			default:		setPivotMoved<true, true>( currentTouchPoints, changedTouchPoints ); break;
 		}
+	}
+	
+	template<bool Rotate, bool Scale>
+	void TouchPivot::setPivotMoved( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &changedTouchPoints )
+	{
+		moveFit<Rotate || Scale>( changedTouchPoints );
 		
-		list<TouchPoint>::iterator touchPointsIt = touchPoints->begin();
-		if ( num < 2 ) {
-			mNode1 = touchPointsIt->getPos();
-			mNode2 = touchPointsIt->getPos();
-		} else {
-			mNode1 = touchPointsIt->getPos();
-			mNode2 = (++touchPointsIt)->getPos();
-			
-			// move rotation
-			float prevRot = mRot;
-			mRot = calcVecAngleDiff( mResetNode2 - mResetNode1, mNode2 - mNode1 );
-			
-			// move scale
-			float prevScale = mScale;
-			mScale = calcVecScaleDiff( mResetNode2 - mResetNode1, mNode2 - mNode1 );
-			
-			// calc rotation/scale velocities
-			mRotAvgVel.push_back( mRot - prevRot );
-			mScaleAvgVel.push_back( mScale - prevScale );
+		const TouchSample *samples = currentTouchPoints.getSamples();
+		mNode1 = samples[0].mPos;
+		mNode2 = ( currentTouchPoints.size() < 2 ) ? samples[0].mPos : samples[1].mPos;
+		
+		if ( ( Rotate || Scale ) && currentTouchPoints.size() > 1 && mFitResetSpread > 0.0 ) {
+			// rotation and scale that best map the reset offsets onto the current ones, in the least-squares sense
+			if ( Rotate ) {
+				float prevRot = mRot;
+				float rotDelta = atan2( mFitCross, mFitDot ) - prevRot;
+				mRot = prevRot + ( rotDelta - 2.0f * M_PI * floorf( ( rotDelta + M_PI ) / ( 2.0f * M_PI ) ) ); // unwrapped, so turns past half a circle keep going
+				mRotAvgVel.push_back( mRot - prevRot );
+			}
+			if ( Scale ) {
+				float prevScale = mScale;
+				mScale = sqrt( mFitDot * mFitDot + mFitCross * mFitCross ) / mFitResetSpread;
+				mScaleAvgVel.push_back( mScale - prevScale );
+			}
 		}
 		
-		// move position
+		// move position to the centroid
 		Vec2f prevPos = mPos;
-		mPos = compositePos;
+		mPos = Vec2f( mFitSumX, mFitSumY ) / float( mNumFitNodes );
 		// calc position velocity
 		mPosAvgVel.push_back( mPos - prevPos );
 	}
 	
 
-	void TouchPivot::touchPointsEnded( list<TouchPoint> *currentTouchPoints, list<TouchPoint> *removedTouchPoints )
+	void TouchPivot::touchPointsEnded( const TouchPointSpan &currentTouchPoints, const TouchPointSpan &removedTouchPoints )
 	{
 		mPrevTime = mTime;
-		mTime = getTime();
+		mTime = calcTime( removedTouchPoints );
 		double deltaTime = mTime - mPrevTime;
 		mDeltaTimeAvg.push_back( deltaTime );
 		mDeltaTimeAvg.push_back( deltaTime );
-		deltaTime = math<double>::clamp( calcDeltaTimeAvg( mDeltaTimeAvg ), mReleaseDeltaTimeMin, mReleaseDeltaTimeMax );
+		deltaTime = math<double>::clamp( mDeltaTimeAvg.getAverage(), mReleaseDeltaTimeMin, mReleaseDeltaTimeMax );
 		
-		mNumTouchPoints = currentTouchPoints->size();
+		mNumTouchPoints = currentTouchPoints.size();
 		
 		// if no starting thesholds have been met, there is no release velocity
 		if ( ! mIsDragging ) {
@@ -220,32 +229,48 @@ namespace Pivot {
 			mRotAvgVel.clear();
 			mScaleAvgVel.clear();
 			mDeltaTimeAvg.clear();
+			resetVelocityEstimators();
 		}
 		
 		Vec2f compositePos;
-		list<TouchPoint>::iterator touchPointsIt = currentTouchPoints->begin();
-		list<TouchPoint>::iterator removedPointsIt = removedTouchPoints->begin();
+		const TouchSample *touchPointsIt = currentTouchPoints.getSamples();
+		const TouchSample *removedPointsIt = removedTouchPoints.getSamples();
 		
 		if ( mNumTouchPoints == 0 ) {
 			
 			// reset and clear pivot
-			for (list<TouchPoint>::iterator it = removedTouchPoints->begin(); it != removedTouchPoints->end(); ++it) {
-				if ( it == removedTouchPoints->begin() ) compositePos = it->getPos();
-				compositePos = ( compositePos + it->getPos() ) / 2;
-			}
+			compositePos = calcCompositePos( removedTouchPoints );
+			mNumFitNodes = 0;
+			mSpilledFitNodes.clear();
 			
-			if ( removedTouchPoints->size() < 2 ) {
-				mNode1 = mResetNode1 = removedPointsIt->getPos();
-				mNode2 = mResetNode2 = removedPointsIt->getPos();
+			if ( removedTouchPoints.size() < 2 ) {
+				mNode1 = mResetNode1 = removedPointsIt->mPos;
+				mNode2 = mResetNode2 = removedPointsIt->mPos;
 			} else {
-				mNode1 = mResetNode1 = removedPointsIt->getPos();
-				mNode2 = mResetNode2 = (++removedPointsIt)->getPos();
+				mNode1 = mResetNode1 = removedPointsIt->mPos;
+				mNode2 = mResetNode2 = (++removedPointsIt)->mPos;
 			}
 			
 			// set new release velocities
-			mReleasePosVel = ( mPosAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? Vec2f::zero() : calcPointAvg( mPosAvgVel ) / deltaTime;
-			mReleaseRotVel = ( mRotAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : calcNumAvg( mRotAvgVel ) / deltaTime;
-			mReleaseScaleVel = ( mScaleAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : calcNumAvg( mScaleAvgVel ) / deltaTime;
+			Vec2f historyPosVel;
+			if ( mIsVelocityEstimated ) {
+				VelocityEstimators &estimators = *mVelocityEstimators;
+				// the lift is a sample too. After a pause longer than the window it restarts the fit, so a held finger lets go still
+				if ( mIsDragging ) {
+					estimators.mPosX.addSample( mTime, compositePos.x );
+					estimators.mPosY.addSample( mTime, compositePos.y );
+				}
+				mReleasePosVel = Vec2f( estimators.mPosX.getVelocity(), estimators.mPosY.getVelocity() );
+				mReleaseRotVel = estimators.mRot.getVelocity();
+				mReleaseScaleVel = estimators.mScale.getVelocity();
+			} else {
+				if ( ! mPosAvgVel.empty() && removedTouchPoints.size() == 1 && calcHistoryPosVel( removedTouchPoints[0].getId(), &historyPosVel ) )
+					mReleasePosVel = historyPosVel;
+				else
+					mReleasePosVel = ( mPosAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? Vec2f::zero() : mPosAvgVel.getAverage() / deltaTime;
+				mReleaseRotVel = ( mRotAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : mRotAvgVel.getAverage() / deltaTime;
+				mReleaseScaleVel = ( mScaleAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : mScaleAvgVel.getAverage() / deltaTime;
+			}
 			
 			// zero out position velocity if below threshold. Clamp if above max.
 			float releasePosVelLen = mReleasePosVel.length();
@@ -273,6 +298,17 @@ namespace Pivot {
 			mRotAvgVel.clear();
 			mScaleAvgVel.clear();
 			mDeltaTimeAvg.clear();
+			resetVelocityEstimators();
+			
+			// position carries on from where the filter had it, rotation and scale start over
+			if ( mIsFiltered ) {
+				PoseFilters &filters = *mFilters;
+				filters.mPos.filter( mPos, mTime );
+				filters.mRot.reset();
+				filters.mScale.reset();
+				filters.mRot.filter( mRot, mTime );
+				filters.mScale.filter( mScale, mTime );
+			}
 			
 			// set inactive
 			mIsActive = false;
@@ -281,25 +317,28 @@ namespace Pivot {
 			
 		} else {
 			
-			for (list<TouchPoint>::iterator it = currentTouchPoints->begin(); it != currentTouchPoints->end(); ++it) {
-				if ( it == currentTouchPoints->begin() ) compositePos = it->getPos();
-				compositePos = ( compositePos + it->getPos() ) / 2;
-			}
+			resetFit( currentTouchPoints );
+			compositePos = calcCompositePos( currentTouchPoints );
 			
 			if ( mNumTouchPoints < 2 ) {
-				mNode1 = mResetNode1 = touchPointsIt->getPos();
-				mNode2 = mResetNode2 = touchPointsIt->getPos();
+				mNode1 = mResetNode1 = touchPointsIt->mPos;
+				mNode2 = mResetNode2 = touchPointsIt->mPos;
 			} else {
-				mNode1 = mResetNode1 = touchPointsIt->getPos();
-				mNode2 = mResetNode2 = (++touchPointsIt)->getPos();
+				mNode1 = mResetNode1 = touchPointsIt->mPos;
+				mNode2 = mResetNode2 = (++touchPointsIt)->mPos;
 			}
 			
 			// set new release velocities
 			mReleasePosVel = Vec2f::zero(); // because at least one touch is still holding down positon
 			if ( mNumTouchPoints == 1 ) {
 				// set new release velocities
-				mReleaseRotVel = ( mRotAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : calcNumAvg( mRotAvgVel ) / deltaTime;
-				mReleaseScaleVel = ( mScaleAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : calcNumAvg( mScaleAvgVel ) / deltaTime;
+				if ( mIsVelocityEstimated ) {
+					mReleaseRotVel = mVelocityEstimators->mRot.getVelocity();
+					mReleaseScaleVel = mVelocityEstimators->mScale.getVelocity();
+				} else {
+					mReleaseRotVel = ( mRotAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : mRotAvgVel.getAverage() / deltaTime;
+					mReleaseScaleVel = ( mScaleAvgVel.empty() || deltaTime > mReleaseDeltaTimeThreshold ) ? 0.0f : mScaleAvgVel.getAverage() / deltaTime;
+				}
 				// zero out rotation velocity if below threshold. Clamp if above max.
 				if ( math<float>::abs( mReleaseRotVel ) < mReleaseRotVelThreshold ) mReleaseRotVel = 0.0f;
 				else mReleaseRotVel = math<float>::clamp( mReleaseRotVel, -mReleaseRotVelMax, mReleaseRotVelMax );
@@ -316,9 +355,12 @@ namespace Pivot {
 			mResetRot = mRot = 0.0f;
 			mResetScale = mScale = 1.0f;
 			
-			// clear velocity buffers
+			// clear velocity buffers. The composite position jumps to the remaining touches, so its fit restarts too
 			mRotAvgVel.clear();
 			mScaleAvgVel.clear();
+			resetVelocityEstimators();
+			addVelocitySamples();
+			filterPose( true );
 		}
 		
 	}
@@ -326,7 +368,7 @@ namespace Pivot {
 	
 	
 	// TODO: remove this when things are in a better state
-	void TouchPivot::draw()
+	void TouchPivot::draw() const
 	{
 		gl::drawStrokedRect( Rectf( -10, -10, 10, 10) + mNode1 );
 		gl::drawStrokedRect( Rectf( -10, -10, 10, 10) + mNode2 );
@@ -337,58 +379,158 @@ namespace Pivot {
 	
 	void TouchPivot::setBufferLengths( int len )
 	{
-		mPosAvgVel = boost::circular_buffer<Vec2f>( len );
-		mRotAvgVel = boost::circular_buffer<float>( len );
-		mScaleAvgVel = boost::circular_buffer<float>( len );
-		mDeltaTimeAvg = boost::circular_buffer<double>( len );
+		mPosAvgVel.setLength( len );
+		mRotAvgVel.setLength( len );
+		mScaleAvgVel.setLength( len );
+		mDeltaTimeAvg.setLength( len );
 	}
 	
 
-	float TouchPivot::calcVecAngleDiff( Vec2f a, Vec2f b )
+	void TouchPivot::setVelocityEstimator( const VelocityEstimator &estimator )
 	{
-		float theta = atan2( a.x, a.y ) - atan2( b.x, b.y );
-		if ( theta > 3.14f ) return theta - 6.28f;
-		else if ( theta < -3.14f ) return 6.28f + theta;
-		else return theta;
+		mIsVelocityEstimated = true;
+		VelocityEstimators &estimators = mVelocityEstimators.get();
+		estimators.mPosX = estimators.mPosY = estimators.mRot = estimators.mScale = estimator;
+		resetVelocityEstimators();
 	}
-
-	float TouchPivot::calcVecScaleDiff( Vec2f a, Vec2f b )
+	
+	void TouchPivot::enableFilter( float minCutoff, float beta, float derivativeCutoff )
 	{
-		return b.length() / a.length();
+		mIsFiltered = true;
+		PoseFilters &filters = mFilters.get();
+		filters.mPos = OneEuroFilter<Vec2f>( minCutoff, beta, derivativeCutoff );
+		filters.mRot = filters.mScale = OneEuroFilter<float>( minCutoff, beta, derivativeCutoff );
+		filterPose( true );
 	}
 	
+	void TouchPivot::filterPose( bool reset )
+	{
+		if ( ! mIsFiltered ) return;
+		PoseFilters &filters = *mFilters;
+		
+		if ( reset ) {
+			// a unit of rotation or scale moves each touch by about the touches' spread
+			float spread = mNumFitNodes == 0 ? 0.0f : math<float>::sqrt( float( mFitResetSpread / mNumFitNodes ) );
+			filters.mRot.setBeta( filters.mPos.getBeta() * spread );
+			filters.mScale.setBeta( filters.mPos.getBeta() * spread );
+			
+			filters.mPos.reset();
+			filters.mRot.reset();
+			filters.mScale.reset();
+		}
+		filters.mPos.filter( mPos, mTime );
+		filters.mRot.filter( mRot, mTime );
+		filters.mScale.filter( mScale, mTime );
+	}
+	
+	void TouchPivot::resetVelocityEstimators()
+	{
+		if ( ! mVelocityEstimators.isAllocated() ) return;
+		
+		VelocityEstimators &estimators = *mVelocityEstimators;
+		estimators.mPosX.reset();
+		estimators.mPosY.reset();
+		estimators.mRot.reset();
+		estimators.mScale.reset();
+	}
 	
-	float TouchPivot::calcNumAvg( boost::circular_buffer<float> numBuffer )
+	void TouchPivot::addVelocitySamples()
 	{
-		float total = 0.0f;
-		int count = 0;
-		for( boost::circular_buffer<float>::iterator it = numBuffer.begin(); it != numBuffer.end(); ++it ) {
-			total += (*it);
-			count++;
+		if ( ! mIsVelocityEstimated ) return;
+		VelocityEstimators &estimators = *mVelocityEstimators;
+		
+		estimators.mPosX.addSample( mTime, mPos.x );
+		estimators.mPosY.addSample( mTime, mPos.y );
+		if ( mNumTouchPoints > 1 ) {
+			if ( mTransforms & ROTATE ) estimators.mRot.addSample( mTime, mRot );
+			if ( mTransforms & SCALE ) estimators.mScale.addSample( mTime, mScale );
 		}
-		return total / float( count );
 	}
-
-	Vec2f TouchPivot::calcPointAvg( boost::circular_buffer<Vec2f> vecBuffer )
+	
+	
+	void TouchPivot::resetFit( const TouchPointSpan &touchPoints )
 	{
-		Vec2f total = Vec2f::zero();
-		int count = 0;
-		for( boost::circular_buffer<Vec2f>::iterator it = vecBuffer.begin(); it != vecBuffer.end(); ++it ) {
-			total += (*it);
-			count++;
+		Vec2f centroid = calcCompositePos( touchPoints );
+		const TouchSample *samples = touchPoints.getSamples();
+		
+		mNumFitNodes = touchPoints.size();
+		mSpilledFitNodes.resize( math<int>::max( mNumFitNodes - TouchPointSet::kInlineCapacity, 0 ) );
+		mFitSumX = mFitSumY = mFitDot = mFitCross = mFitResetSpread = 0.0;
+		for( int i = 0; i < touchPoints.size(); ++i ) {
+			FitNode &node = getFitNode( i );
+			node.mId = samples[i].mId;
+			node.mPos = samples[i].mPos;
+			node.mResetOffset = samples[i].mPos - centroid;
+			
+			// offsets sum to zero, so dotting them with positions is the same as with centered positions
+			mFitSumX += node.mPos.x;
+			mFitSumY += node.mPos.y;
+			mFitDot += node.mResetOffset.dot( node.mPos );
+			mFitCross += node.mResetOffset.x * node.mPos.y - node.mResetOffset.y * node.mPos.x;
+			mFitResetSpread += node.mResetOffset.lengthSquared();
 		}
-		return total / float( count );
 	}
 	
-	double TouchPivot::calcDeltaTimeAvg( boost::circular_buffer<double> numBuffer )
+	template<bool Moments>
+	void TouchPivot::moveFit( const TouchPointSpan &changedTouchPoints )
 	{
-		float total = 0.0;
-		int count = 0;
-		for( boost::circular_buffer<double>::iterator it = numBuffer.begin(); it != numBuffer.end(); ++it ) {
-			total += (*it);
-			count++;
+		const TouchSample *samples = changedTouchPoints.getSamples();
+		int numNodes = mNumFitNodes;
+		int index = 0;
+		for( int i = 0; i < changedTouchPoints.size(); ++i ) {
+			// changed touches come in the same order as the nodes, so the search resumes where the last one stopped
+			int searched = 0;
+			while( searched < numNodes && getFitNode( index ).mId != samples[i].mId ) {
+				index = ( index + 1 ) % numNodes;
+				++searched;
+			}
+			if ( searched == numNodes ) continue;
+			FitNode *nodeIt = &getFitNode( index );
+			
+			Vec2f delta = samples[i].mPos - nodeIt->mPos;
+			nodeIt->mPos = samples[i].mPos;
+			mFitSumX += delta.x;
+			mFitSumY += delta.y;
+			if ( Moments ) {
+				mFitDot += nodeIt->mResetOffset.dot( delta );
+				mFitCross += nodeIt->mResetOffset.x * delta.y - nodeIt->mResetOffset.y * delta.x;
+			}
 		}
-		return total / double( count );
+	}
+	
+	Vec2f TouchPivot::calcCompositePos( const TouchPointSpan &touchPoints )
+	{
+		if ( touchPoints.empty() ) return Vec2f::zero();
+		
+		const TouchSample *samples = touchPoints.getSamples();
+		Vec2f compositePos = Vec2f::zero();
+		for( int i = 0; i < touchPoints.size(); ++i )
+			compositePos += samples[i].mPos;
+		return compositePos / float( touchPoints.size() );
+	}
+	
+	
+	bool TouchPivot::calcHistoryPosVel( uint32_t id, Vec2f *vel ) const
+	{
+		if ( ! mTouchHistory ) return false;
+		
+		// same span as the averaging buffers, but in raw samples rather than events
+		int count = math<int>::min( mTouchHistory->numSamples( id ), mPosAvgVel.getLength() + 1 );
+		if ( count < 2 ) return false;
+		
+		TouchSample newest = mTouchHistory->getSample( id, 0 );
+		TouchSample oldest = mTouchHistory->getSample( id, count - 1 );
+		double deltaTime = uint32_t( newest.mTicks - oldest.mTicks ) / double( TouchSample::kTicksPerSecond );
+		if ( deltaTime <= 0.0 ) return false;
+		
+		*vel = ( newest.mPos - oldest.mPos ) / deltaTime;
+		return true;
+	}
+	
+	double TouchPivot::calcTime( const TouchPointSpan &touchPoints ) const
+	{
+		// never step back, e.g. when a touch source mixes stamped and unstamped touches
+		return math<double>::max( mTouchClock->getTime( touchPoints ) - mBeginTime, mTime );
 	}
 	
 }
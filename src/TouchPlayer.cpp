@@ -0,0 +1,151 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "TouchObject.h"
+#include "TouchPlayer.h"
+#include "TouchScene.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	template<typename T>
+	static void playToTouchObject( T *target, TouchPhase phase, const TouchEvent &event )
+	{
+		TouchList touches = toList( event.getTouches() );
+		switch( phase ) {
+			case TOUCH_BEGAN: target->touchesBegan( &touches ); break;
+			case TOUCH_MOVED: target->touchesMoved( &touches ); break;
+			case TOUCH_ENDED: target->touchesEnded( &touches ); break;
+			case TOUCH_CANCELLED: target->touchesCancelled( &touches ); break;
+		}
+	}
+	
+	
+	TouchPlayer::TouchPlayer()
+	: mRecords( NULL ), mNumRecords( 0 ), mNextRecord( 0 ), mTimeOffset( 0.0 )
+	{}
+	
+	bool TouchPlayer::load( const fs::path &path )
+	{
+		FILE *file = fopen( path.string().c_str(), "rb" );
+		if ( ! file ) return false;
+		
+		vector<char> data;
+		fseek( file, 0, SEEK_END );
+		long size = ftell( file );
+		fseek( file, 0, SEEK_SET );
+		if ( size > 0 ) {
+			data.resize( size );
+			size = fread( &data[0], 1, size, file );
+		}
+		fclose( file );
+		
+		mOwnedData.swap( data );
+		if ( load( mOwnedData.empty() ? NULL : &mOwnedData[0], size ) ) return true;
+		mOwnedData.clear();
+		return false;
+	}
+	
+	bool TouchPlayer::load( const void *data, size_t size )
+	{
+		mRecords = NULL;
+		mNumRecords = mNextRecord = 0;
+		
+		TouchFileHeader header;
+		if ( ! data || size < sizeof( header ) ) return false;
+		memcpy( &header, data, sizeof( header ) );
+		if ( header.mMagic != TouchFileHeader::kMagic || header.mVersion != TouchFileHeader::kVersion || header.mRecordSize != sizeof( TouchFileRecord ) )
+			return false;
+		// the records must start inside the data, aligned for their timestamps
+		if ( header.mHeaderSize < sizeof( header ) || header.mHeaderSize > size || header.mHeaderSize % sizeof( double ) != 0 )
+			return false;
+		
+		// a recording that wasn't closed has no count, so trust the file size
+		uint32_t numRecords = ( size - header.mHeaderSize ) / sizeof( TouchFileRecord );
+		if ( header.mNumRecords != 0 && header.mNumRecords < numRecords ) numRecords = header.mNumRecords;
+		
+		mRecords = reinterpret_cast<const TouchFileRecord*>( static_cast<const char*>( data ) + header.mHeaderSize );
+		mNumRecords = numRecords;
+		return true;
+	}
+	
+	void TouchPlayer::setTarget( TouchScene *scene )
+	{
+		mTarget = std::bind( &playToTouchObject<TouchScene>, scene, std::placeholders::_1, std::placeholders::_2 );
+	}
+	
+	void TouchPlayer::setTarget( TouchObject *object )
+	{
+		mTarget = std::bind( &playToTouchObject<TouchObject>, object, std::placeholders::_1, std::placeholders::_2 );
+	}
+	
+	void TouchPlayer::playAll()
+	{
+		while( ! isDone() )
+			playEvent( 0.0 );
+	}
+	
+	void TouchPlayer::start( double time )
+	{
+		mNextRecord = 0;
+		mTimeOffset = ( mNumRecords > 0 ) ? time - mRecords[0].mTime : 0.0;
+	}
+	
+	void TouchPlayer::update( double time )
+	{
+		while( ! isDone() && mRecords[mNextRecord].mTime + mTimeOffset <= time )
+			playEvent( mTimeOffset );
+	}
+	
+	double TouchPlayer::getDuration() const
+	{
+		if ( mNumRecords == 0 ) return 0.0;
+		return mRecords[mNumRecords - 1].mTime - mRecords[0].mTime;
+	}
+	
+	void TouchPlayer::playEvent( double timeOffset )
+	{
+		mTouches.clear();
+		
+		TouchPhase phase = TOUCH_MOVED;
+		while( mNextRecord < mNumRecords ) {
+			const TouchFileRecord &record = mRecords[mNextRecord++];
+			phase = TouchPhase( record.mPhase );
+			mTouches.push_back( TouchEvent::Touch( Vec2f( record.mPosX, record.mPosY ), Vec2f( record.mPrevPosX, record.mPrevPosY ), record.mId, record.mTime + timeOffset, NULL ) );
+			if ( record.mFlags & TouchFileRecord::LAST_IN_EVENT ) break;
+		}
+		
+		if ( ! mTouches.empty() && mTarget ) mTarget( phase, TouchEvent( mTouches ) );
+	}
+	
+}
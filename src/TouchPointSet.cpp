@@ -0,0 +1,117 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <algorithm>
+
+#include "TouchPointSet.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	TouchPointSet::TouchPointSet()
+	: mPoints( mInlinePoints ), mSamples( mInlineSamples ), mSize( 0 ), mCapacity( kInlineCapacity )
+	{}
+	
+	TouchPointSet::TouchPointSet( const TouchPointSet &other )
+	: mPoints( mInlinePoints ), mSamples( mInlineSamples ), mSize( 0 ), mCapacity( kInlineCapacity )
+	{
+		*this = other;
+	}
+	
+	TouchPointSet::~TouchPointSet()
+	{
+		if ( mPoints != mInlinePoints ) {
+			delete [] mPoints;
+			delete [] mSamples;
+		}
+	}
+	
+	TouchPointSet& TouchPointSet::operator=( const TouchPointSet &other )
+	{
+		if ( this != &other ) {
+			reserve( other.mSize );
+			copy( other.mPoints, other.mPoints + other.mSize, mPoints );
+			copy( other.mSamples, other.mSamples + other.mSize, mSamples );
+			mSize = other.mSize;
+		}
+		return *this;
+	}
+	
+	int TouchPointSet::find( uint32_t id ) const
+	{
+		for( int i = 0; i < mSize; ++i )
+			if ( mSamples[i].mId == id ) return i;
+		return -1;
+	}
+	
+	void TouchPointSet::push_back( const TouchPoint &touchPoint )
+	{
+		if ( mSize == mCapacity ) reserve( mCapacity * 2 );
+		mPoints[mSize] = touchPoint;
+		mSamples[mSize] = touchPoint.getSample();
+		++mSize;
+	}
+	
+	void TouchPointSet::erase( int slot )
+	{
+		copy( mPoints + slot + 1, mPoints + mSize, mPoints + slot );
+		copy( mSamples + slot + 1, mSamples + mSize, mSamples + slot );
+		--mSize;
+	}
+	
+	void TouchPointSet::move( int slot, const Vec2f &pos, const Vec2f &prevPos, double time )
+	{
+		TouchPoint &touchPoint = mPoints[slot];
+		touchPoint.setPrevPos( prevPos );
+		touchPoint.setPos( pos );
+		touchPoint.setPrevTime( touchPoint.getTime() );
+		touchPoint.setTime( time );
+		mSamples[slot] = touchPoint.getSample();
+	}
+	
+	void TouchPointSet::reserve( int capacity )
+	{
+		if ( capacity <= mCapacity ) return;
+		
+		// spill to the heap, only ever hit with more than kInlineCapacity simultaneous touches
+		TouchPoint *points = new TouchPoint[capacity];
+		TouchSample *samples = new TouchSample[capacity];
+		copy( mPoints, mPoints + mSize, points );
+		copy( mSamples, mSamples + mSize, samples );
+		
+		if ( mPoints != mInlinePoints ) {
+			delete [] mPoints;
+			delete [] mSamples;
+		}
+		mPoints = points;
+		mSamples = samples;
+		mCapacity = capacity;
+	}
+	
+}
@@ -0,0 +1,117 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include <cstddef>
+
+#include "TouchRecorder.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	TouchRecorder::TouchRecorder()
+	: mFile( NULL ), mNumRecords( 0 ), mHasFailed( false )
+	{
+		mBuffer.reserve( kBufferSize );
+	}
+	
+	TouchRecorder::~TouchRecorder()
+	{
+		close();
+	}
+	
+	bool TouchRecorder::open( const fs::path &path )
+	{
+		close();
+		
+		mFile = fopen( path.string().c_str(), "wb" );
+		if ( ! mFile ) return false;
+		
+		// the record count is filled in by close()
+		TouchFileHeader header = TouchFileHeader();
+		header.mMagic = TouchFileHeader::kMagic;
+		header.mVersion = TouchFileHeader::kVersion;
+		header.mHeaderSize = sizeof( TouchFileHeader );
+		header.mRecordSize = sizeof( TouchFileRecord );
+		
+		mNumRecords = 0;
+		mHasFailed = fwrite( &header, sizeof( header ), 1, mFile ) != 1;
+		return true;
+	}
+	
+	bool TouchRecorder::close()
+	{
+		if ( ! mFile ) return true;
+		
+		flush();
+		if ( fseek( mFile, offsetof( TouchFileHeader, mNumRecords ), SEEK_SET ) != 0
+			|| fwrite( &mNumRecords, sizeof( mNumRecords ), 1, mFile ) != 1 ) mHasFailed = true;
+		// buffered writes can still fail here
+		if ( fclose( mFile ) != 0 ) mHasFailed = true;
+		mFile = NULL;
+		return ! mHasFailed;
+	}
+	
+	void TouchRecorder::record( TouchPhase phase, const vector<TouchEvent::Touch> &touches )
+	{
+		if ( ! mFile || mHasFailed ) return;
+		
+		for( size_t i = 0; i < touches.size(); ++i ) {
+			const TouchEvent::Touch &touch = touches[i];
+			TouchFileRecord record = TouchFileRecord();
+			record.mTime = touch.getTime();
+			record.mPosX = touch.getPos().x;
+			record.mPosY = touch.getPos().y;
+			record.mPrevPosX = touch.getPrevPos().x;
+			record.mPrevPosY = touch.getPrevPos().y;
+			record.mId = touch.getId();
+			record.mPhase = phase;
+			record.mFlags = ( i == touches.size() - 1 ) ? TouchFileRecord::LAST_IN_EVENT : 0;
+			mBuffer.push_back( record );
+			++mNumRecords;
+			
+			if ( mBuffer.size() == kBufferSize && ! flush() ) return;
+		}
+	}
+	
+	bool TouchRecorder::flush()
+	{
+		if ( mBuffer.empty() ) return true;
+		
+		size_t numWritten = fwrite( &mBuffer[0], sizeof( TouchFileRecord ), mBuffer.size(), mFile );
+		if ( numWritten != mBuffer.size() ) {
+			// leave the failed records out of the header's count
+			mNumRecords -= mBuffer.size() - numWritten;
+			mHasFailed = true;
+		}
+		mBuffer.clear();
+		return ! mHasFailed;
+	}
+	
+}
@@ -0,0 +1,463 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+#include <algorithm>
+
+#include "TouchScene.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace ci::app;
+	using namespace std;
+	
+	TouchScene::TouchScene( const Rectf &gridBounds, float cellSize )
+	{
+		mGridDirty = true;
+		mObjectsDirty = false;
+		mFrontDepth = mBackDepth = 0;
+		mNumHits = 0;
+		mIsClustering = false;
+		mTouchHistory = NULL;
+		mTouchClock = NULL;
+		setGrid( gridBounds, cellSize );
+	}
+	
+	TouchScene::~TouchScene()
+	{
+		for( vector<TouchObject*>::iterator it = mObjects.begin(); it != mObjects.end(); ++it )
+			(*it)->mSceneLink.reset();
+	}
+	
+	
+	void TouchScene::addObject( TouchObject *object )
+	{
+		if ( object->mSceneLink.mScene == this ) return;
+		if ( object->mSceneLink.mScene ) object->mSceneLink.mScene->removeObject( object );
+		
+		// entries keep their index while in the scene, depth order lives in their depth keys
+		int index;
+		if ( mFreeIndices.empty() ) {
+			index = mEntries.size();
+			mEntries.push_back( Entry() );
+		} else {
+			index = mFreeIndices.back();
+			mFreeIndices.pop_back();
+		}
+		mEntries[index].mObject = object;
+		mEntries[index].mDepth = ++mBackDepth;
+		
+		object->mSceneLink.mScene = this;
+		object->mSceneLink.mOwner = object;
+		object->mSceneLink.mIndex = index;
+		mObjects.push_back( object );
+		mDirtyIndices.push_back( index );
+		if ( mTouchHistory ) object->setTouchHistory( mTouchHistory );
+		if ( mTouchClock ) object->setTouchClock( mTouchClock );
+	}
+	
+	void TouchScene::setTouchHistory( const TouchHistory *touchHistory )
+	{
+		mTouchHistory = touchHistory;
+		for( vector<TouchObject*>::iterator it = mObjects.begin(); it != mObjects.end(); ++it )
+			(*it)->setTouchHistory( touchHistory );
+	}
+	
+	void TouchScene::setTouchClock( const TouchClock *touchClock )
+	{
+		mTouchClock = touchClock;
+		for( vector<TouchObject*>::iterator it = mObjects.begin(); it != mObjects.end(); ++it )
+			(*it)->setTouchClock( touchClock );
+	}
+	
+	void TouchScene::removeObject( TouchObject *object )
+	{
+		if ( object->mSceneLink.mScene != this ) return;
+		
+		int index = object->mSceneLink.mIndex;
+		removeCells( index );
+		uint32_t generation = mEntries[index].mGeneration + 1;
+		mEntries[index] = Entry();
+		mEntries[index].mGeneration = generation;
+		mFreeIndices.push_back( index );
+		mObjects.erase( find( mObjects.begin(), mObjects.end(), object ) );
+		object->mSceneLink.reset();
+		
+		// forget the object's touches
+		for( RouteMap::iterator it = mRoutes.begin(); it != mRoutes.end(); ++it ) {
+			Route &route = it->second;
+			TouchObject **last = remove( route.mOwners, route.mOwners + route.mNumOwners, object );
+			route.mNumOwners = last - route.mOwners;
+		}
+	}
+	
+	void TouchScene::bringToFront( TouchObject *object )
+	{
+		if ( object->mSceneLink.mScene != this ) return;
+		Entry &entry = mEntries[object->mSceneLink.mIndex];
+		if ( entry.mDepth == mFrontDepth ) return;
+		setDepth( object->mSceneLink.mIndex, --mFrontDepth );
+	}
+	
+	void TouchScene::sendToBack( TouchObject *object )
+	{
+		if ( object->mSceneLink.mScene != this ) return;
+		Entry &entry = mEntries[object->mSceneLink.mIndex];
+		if ( entry.mDepth == mBackDepth ) return;
+		setDepth( object->mSceneLink.mIndex, ++mBackDepth );
+	}
+	
+	void TouchScene::setDepth( int index, int64_t depth )
+	{
+		// only the moved object's cells change, and it goes to one end of each
+		bool inCells = mEntries[index].mInCells;
+		if ( inCells ) removeCells( index );
+		mEntries[index].mDepth = depth;
+		if ( inCells ) insertCells( index );
+		mObjectsDirty = true;
+	}
+	
+	const vector<TouchObject*>& TouchScene::getObjects() const
+	{
+		if ( mObjectsDirty ) {
+			stable_sort( mObjects.begin(), mObjects.end(), ObjectDepthCompare( &mEntries ) );
+			mObjectsDirty = false;
+		}
+		return mObjects;
+	}
+	
+	void TouchScene::markBoundsDirty( TouchObject *object )
+	{
+		Entry &entry = mEntries[object->mSceneLink.mIndex];
+		if ( ! entry.mDirty ) {
+			entry.mDirty = true;
+			mDirtyIndices.push_back( object->mSceneLink.mIndex );
+		}
+	}
+	
+	void TouchScene::setGrid( const Rectf &gridBounds, float cellSize )
+	{
+		mGridBounds = gridBounds;
+		mCellSize = math<float>::max( cellSize, 1.0f );
+		mInvCellSize = 1.0f / mCellSize;
+		mNumCellsX = math<int>::max( 1, (int)math<float>::ceil( mGridBounds.getWidth() * mInvCellSize ) );
+		mNumCellsY = math<int>::max( 1, (int)math<float>::ceil( mGridBounds.getHeight() * mInvCellSize ) );
+		mCells.assign( mNumCellsX * mNumCellsY, vector<int>() );
+		mUnbounded.clear();
+		
+		// entries' cell ranges belong to the old grid, so nothing may remove them from the new one before it's rebuilt
+		for( vector<Entry>::iterator it = mEntries.begin(); it != mEntries.end(); ++it ) {
+			it->mInCells = false;
+			it->mCellX1 = it->mCellY1 = 0;
+			it->mCellX2 = it->mCellY2 = -1;
+		}
+		mGridDirty = true;
+	}
+	
+	
+	
+	void TouchScene::enableClustering( float linkDistance, float rejoinTime )
+	{
+		mClusterer.setLinkDistance( linkDistance );
+		mClusterer.setRejoinTime( rejoinTime );
+		mIsClustering = true;
+	}
+	
+	void TouchScene::disableClustering()
+	{
+		mClusterer.clear();
+		mIsClustering = false;
+	}
+	
+	
+	void TouchScene::touchesBegan( TouchList *touches )
+	{
+		refreshBounds();
+		if ( mIsClustering ) mClusterer.touchesBegan( *touches );
+		
+		TouchList::iterator touchIt = touches->begin();
+		while( touchIt != touches->end() ) {
+			const vector<int> &cell = mCells[cellIndex( touchIt->getPos() )];
+			EntryDepthCompare depthCompare( &mEntries );
+			vector<int>::const_iterator cellIt = cell.begin();
+			vector<int>::const_iterator unboundedIt = mUnbounded.begin();
+			Route *route = NULL;
+			int cluster = mIsClustering ? mClusterer.getCluster( touchIt->getId() ) : -1;
+			mRoutes.erase( touchIt->getId() );
+			
+			// walk the touched cell and the unbounded objects together, front to back
+			while( cellIt != cell.end() || unboundedIt != mUnbounded.end() ) {
+				int index;
+				if ( unboundedIt == mUnbounded.end() || ( cellIt != cell.end() && depthCompare( *cellIt, *unboundedIt ) ) ) index = *cellIt++;
+				else index = *unboundedIt++;
+				
+				const Entry &entry = mEntries[index];
+				if ( entry.mBounded && ! entry.mBounds.contains( touchIt->getPos() ) ) continue;
+				
+				TouchObject *object = entry.mObject;
+				if ( object->hitTest( *touchIt ) && object->acceptsCluster( cluster ) ) {
+					addHit( index, *touchIt );
+					
+					// remember who owns the touch, so later events skip straight to them
+					if ( ! route ) route = &mRoutes[touchIt->getId()];
+					if ( route->mNumOwners < kMaxRouteOwners ) route->mOwners[route->mNumOwners++] = object;
+					else route->mBroadcast = true;
+					
+					if ( object->getCaptureMode() ) {
+						route->mCaptured = true;
+						break;
+					}
+				}
+			}
+			
+			if ( route && route->mCaptured ) touchIt = touches->erase( touchIt );
+			else ++touchIt;
+		}
+		
+		flushHits( &TouchObject::acceptTouches );
+	}
+	
+	void TouchScene::touchesMoved( TouchList *touches )
+	{
+		if ( mIsClustering ) mClusterer.touchesMoved( *touches );
+		routeTouches( touches, &TouchObject::moveTouches, &TouchObject::touchesMoved, false );
+	}
+	
+	void TouchScene::touchesEnded( TouchList *touches )
+	{
+		if ( mIsClustering ) mClusterer.touchesEnded( *touches );
+		routeTouches( touches, &TouchObject::endTouches, &TouchObject::touchesEnded, true );
+	}
+	
+	void TouchScene::touchesCancelled( TouchList *touches )
+	{
+		if ( mIsClustering ) mClusterer.touchesEnded( *touches );
+		routeTouches( touches, &TouchObject::cancelTouches, &TouchObject::touchesCancelled, true );
+	}
+	
+	void TouchScene::routeTouches( TouchList *touches, TouchesFn ownedTouchesFn, void (TouchObject::*touchesFn)( TouchList* ), bool releaseRoutes )
+	{
+		TouchList::iterator touchIt = touches->begin();
+		while( touchIt != touches->end() ) {
+			RouteMap::iterator routeIt = mRoutes.find( touchIt->getId() );
+			if ( routeIt == mRoutes.end() ) {
+				++touchIt;
+				continue;
+			}
+			
+			const Route &route = routeIt->second;
+			if ( route.mBroadcast ) {
+				mBroadcastTouches.push_back( *touchIt );
+			} else {
+				for( int i = 0; i < route.mNumOwners; ++i )
+					addHit( route.mOwners[i]->mSceneLink.mIndex, *touchIt );
+			}
+			
+			bool captured = route.mCaptured;
+			if ( releaseRoutes ) mRoutes.erase( routeIt );
+			if ( captured ) touchIt = touches->erase( touchIt );
+			else ++touchIt;
+		}
+		
+		flushHits( ownedTouchesFn );
+		
+		// touches with too many non-capturing owners fall back to offering them to every object
+		if ( ! mBroadcastTouches.empty() ) {
+			getObjects();
+			for( vector<TouchObject*>::iterator it = mObjects.begin(); it != mObjects.end(); ++it ) {
+				if ( mBroadcastTouches.empty() ) break;
+				((*it)->*touchesFn)( &mBroadcastTouches );
+			}
+			mBroadcastTouches.clear();
+		}
+	}
+	
+	void TouchScene::addHit( int index, const TouchEvent::Touch &touch )
+	{
+		Entry &entry = mEntries[index];
+		if ( entry.mHitSlot < 0 ) {
+			entry.mHitSlot = mNumHits++;
+			if ( (int)mHits.size() < mNumHits ) mHits.resize( mNumHits );
+			mHits[entry.mHitSlot].mIndex = index;
+			mHits[entry.mHitSlot].mGeneration = entry.mGeneration;
+			mHits[entry.mHitSlot].mObject = entry.mObject;
+			mHits[entry.mHitSlot].mDepth = entry.mDepth;
+			mHits[entry.mHitSlot].mTouches.clear();
+			mHitOrder.push_back( entry.mHitSlot );
+		}
+		mHits[entry.mHitSlot].mTouches.push_back( touch );
+	}
+	
+	void TouchScene::flushHits( TouchesFn touchesFn )
+	{
+		if ( mNumHits == 0 ) return;
+		
+		// objects may be reordered or removed by their callbacks, so release the slots before dispatching
+		for( int i = 0; i < mNumHits; ++i )
+			mEntries[mHits[i].mIndex].mHitSlot = -1;
+		sort( mHitOrder.begin(), mHitOrder.end(), HitDepthCompare( &mHits ) );
+		
+		for( vector<int>::iterator it = mHitOrder.begin(); it != mHitOrder.end(); ++it ) {
+			// skip objects an earlier callback removed, which may no longer exist, even if another object took their index since
+			const Hit &hit = mHits[*it];
+			if ( mEntries[hit.mIndex].mGeneration != hit.mGeneration ) continue;
+			(hit.mObject->*touchesFn)( hit.mTouches );
+		}
+		
+		mHitOrder.clear();
+		mNumHits = 0;
+	}
+	
+	
+	void TouchScene::update( float deltaTime )
+	{
+		getObjects();
+		for( vector<TouchObject*>::reverse_iterator it = mObjects.rbegin(); it != mObjects.rend(); ++it )
+			(*it)->update( deltaTime );
+	}
+	
+	
+	
+	void TouchScene::refreshBounds()
+	{
+		if ( mGridDirty ) {
+			rebuildGrid();
+			return;
+		}
+		
+		for( vector<int>::iterator it = mDirtyIndices.begin(); it != mDirtyIndices.end(); ++it )
+			if ( mEntries[*it].mObject && mEntries[*it].mDirty ) updateCells( *it );
+		mDirtyIndices.clear();
+	}
+	
+	void TouchScene::rebuildGrid()
+	{
+		for( vector< vector<int> >::iterator it = mCells.begin(); it != mCells.end(); ++it )
+			it->clear();
+		mUnbounded.clear();
+		
+		// inserting front to back keeps every cell sorted
+		const vector<TouchObject*> &objects = getObjects();
+		for( vector<TouchObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it ) {
+			int i = (*it)->mSceneLink.mIndex;
+			Entry &entry = mEntries[i];
+			entry.mBounded = (*it)->getBounds( &entry.mBounds );
+			entry.mDirty = false;
+			entry.mInCells = true;
+			if ( entry.mBounded ) {
+				cellRange( entry.mBounds, &entry.mCellX1, &entry.mCellY1, &entry.mCellX2, &entry.mCellY2 );
+				for( int y = entry.mCellY1; y <= entry.mCellY2; ++y )
+					for( int x = entry.mCellX1; x <= entry.mCellX2; ++x )
+						mCells[y * mNumCellsX + x].push_back( i );
+			} else {
+				mUnbounded.push_back( i );
+			}
+		}
+		
+		mDirtyIndices.clear();
+		mGridDirty = false;
+	}
+	
+	void TouchScene::updateCells( int index )
+	{
+		Entry &entry = mEntries[index];
+		entry.mDirty = false;
+		
+		Rectf bounds;
+		bool bounded = entry.mObject->getBounds( &bounds );
+		
+		if ( bounded && entry.mBounded && entry.mInCells ) {
+			int x1, y1, x2, y2;
+			cellRange( bounds, &x1, &y1, &x2, &y2 );
+			if ( x1 == entry.mCellX1 && y1 == entry.mCellY1 && x2 == entry.mCellX2 && y2 == entry.mCellY2 ) {
+				entry.mBounds = bounds;
+				return;
+			}
+		}
+		
+		removeCells( index );
+		entry.mBounded = bounded;
+		entry.mBounds = bounds;
+		insertCells( index );
+	}
+	
+	void TouchScene::insertCells( int index )
+	{
+		Entry &entry = mEntries[index];
+		EntryDepthCompare depthCompare( &mEntries );
+		if ( entry.mBounded ) {
+			cellRange( entry.mBounds, &entry.mCellX1, &entry.mCellY1, &entry.mCellX2, &entry.mCellY2 );
+			for( int y = entry.mCellY1; y <= entry.mCellY2; ++y ) {
+				for( int x = entry.mCellX1; x <= entry.mCellX2; ++x ) {
+					vector<int> &cell = mCells[y * mNumCellsX + x];
+					cell.insert( lower_bound( cell.begin(), cell.end(), index, depthCompare ), index );
+				}
+			}
+		} else {
+			mUnbounded.insert( lower_bound( mUnbounded.begin(), mUnbounded.end(), index, depthCompare ), index );
+		}
+		entry.mInCells = true;
+	}
+	
+	void TouchScene::removeCells( int index )
+	{
+		Entry &entry = mEntries[index];
+		if ( ! entry.mInCells ) return;
+		EntryDepthCompare depthCompare( &mEntries );
+		if ( entry.mBounded ) {
+			for( int y = entry.mCellY1; y <= entry.mCellY2; ++y ) {
+				for( int x = entry.mCellX1; x <= entry.mCellX2; ++x ) {
+					vector<int> &cell = mCells[y * mNumCellsX + x];
+					vector<int>::iterator it = lower_bound( cell.begin(), cell.end(), index, depthCompare );
+					if ( it != cell.end() && *it == index ) cell.erase( it );
+				}
+			}
+			entry.mCellX2 = entry.mCellY2 = -1;
+		} else {
+			vector<int>::iterator it = lower_bound( mUnbounded.begin(), mUnbounded.end(), index, depthCompare );
+			if ( it != mUnbounded.end() && *it == index ) mUnbounded.erase( it );
+		}
+		entry.mInCells = false;
+	}
+	
+	int TouchScene::cellIndex( const Vec2f &pos ) const
+	{
+		int x = math<int>::clamp( (int)math<float>::floor( ( pos.x - mGridBounds.x1 ) * mInvCellSize ), 0, mNumCellsX - 1 );
+		int y = math<int>::clamp( (int)math<float>::floor( ( pos.y - mGridBounds.y1 ) * mInvCellSize ), 0, mNumCellsY - 1 );
+		return y * mNumCellsX + x;
+	}
+	
+	void TouchScene::cellRange( const Rectf &bounds, int *x1, int *y1, int *x2, int *y2 ) const
+	{
+		*x1 = math<int>::clamp( (int)math<float>::floor( ( bounds.x1 - mGridBounds.x1 ) * mInvCellSize ), 0, mNumCellsX - 1 );
+		*y1 = math<int>::clamp( (int)math<float>::floor( ( bounds.y1 - mGridBounds.y1 ) * mInvCellSize ), 0, mNumCellsY - 1 );
+		*x2 = math<int>::clamp( (int)math<float>::floor( ( bounds.x2 - mGridBounds.x1 ) * mInvCellSize ), 0, mNumCellsX - 1 );
+		*y2 = math<int>::clamp( (int)math<float>::floor( ( bounds.y2 - mGridBounds.y1 ) * mInvCellSize ), 0, mNumCellsY - 1 );
+	}
+	
+}
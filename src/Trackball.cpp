@@ -41,11 +41,11 @@ namespace Pivot {
 	{
 		mVelDecay = 0.99f;
 		mOriginRadius = mPivotResetRadius = mRadius;
-		mOffsetQuat = Quatf( 0.0f, 0.0f, 0.0f, 1.0f );
-		mRotQuat = Quatf( 0.0f, 0.0f, 0.0f, 1.0f );
 		mPrevBaseAxis = Vec3f::zAxis();
+		mIsOrientationFiltered = false;
+		mFilterTime = 0.0;
 		reset();
-		mBaseArcball.setOrigin( mCenter, getOrientation(), mCenter, mRadius );
+		mBaseArcball.setOrigin( mCenter, calcOrientation(), mCenter, mRadius );
 		mOrientationVel = Vec3f::zero();
 		
 		mMinRadius = 1.0f;
@@ -59,12 +59,18 @@ namespace Pivot {
 	{
 		return bool( touch.getPos().distance( mCenter ) < mRadius );
 	}
+	
+	bool Trackball::getBounds( Rectf *bounds )
+	{
+		*bounds = Rectf( mCenter.x - mRadius, mCenter.y - mRadius, mCenter.x + mRadius, mCenter.y + mRadius );
+		return true;
+	}
 
 
 	void Trackball::pivotBegan( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mRadius;
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mCenter, mRadius );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mCenter, mRadius );
 		mRot = touchPivot->getRot();
 		mRotVel = 0.0f;
 		mPrevBaseAxis = mBaseArcball.getToAxis();
@@ -78,6 +84,7 @@ namespace Pivot {
 		if ( touchPivot->numTouchPoints() > 1 ) {
 			mRot = touchPivot->getRot();
 			mRadius = limit( mPivotResetRadius * touchPivot->getScale(), mPullResistance, mMinRadius, mMaxRadius );
+			markBoundsDirty();
 		}
 		
 		mBaseArcball.move( touchPivot->getPos(), mCenter, mRadius );
@@ -93,7 +100,7 @@ namespace Pivot {
 	void Trackball::pivotReset( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mRadius;
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mCenter, mRadius );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mCenter, mRadius );
 		mPrevBaseAxis = mBaseArcball.getToAxis();
 		mPrevOrientation = mBaseArcball.getQuat();
 		mRot = touchPivot->getRot();
@@ -113,7 +120,7 @@ namespace Pivot {
 	void Trackball::pivotEnded( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mRadius;
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mCenter, mRadius );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mCenter, mRadius );
 		mRot = touchPivot->getRot();
 
 		if ( mBaseArcball.getToAxis() != mPrevBaseAxis ) {
@@ -149,7 +156,7 @@ namespace Pivot {
 	void Trackball::pivotCancelled( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mRadius;
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mCenter, mRadius );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mCenter, mRadius );
 		mPrevBaseAxis = mBaseArcball.getToAxis();
 		mRot = touchPivot->getRot();
 		mRotVel = 0.0f;
@@ -159,16 +166,15 @@ namespace Pivot {
 
 
 	// Dear community, I'm not very good with vector and quaternion math, can this be optimized?
-	Quatf Trackball::getOrientation() { 
+	Quatf Trackball::calcOrientation( const Trackball::Arcball &arcball, float rot ) const { 
 		// normalize to z axis
-		mOffsetQuat.set( mBaseArcball.getToAxis(), Vec3f::zAxis() );
-		Quatf normalizedQuat = mBaseArcball.getQuat() * (mOffsetQuat * mOffsetQuat);
+		Quatf offsetQuat( arcball.getToAxis(), Vec3f::zAxis() );
+		Quatf normalizedQuat = arcball.getQuat() * (offsetQuat * offsetQuat);
 		// rotate around z axis
-		mRotQuat.set( Vec3f::zAxis(), mRot );
-		normalizedQuat = normalizedQuat * mRotQuat;
+		normalizedQuat = normalizedQuat * Quatf( Vec3f::zAxis(), rot );
 		// restore orientation
-		mOffsetQuat.set( Vec3f::zAxis(), mBaseArcball.getToAxis() );
-		normalizedQuat = normalizedQuat * (mOffsetQuat * mOffsetQuat);
+		offsetQuat.set( Vec3f::zAxis(), arcball.getToAxis() );
+		normalizedQuat = normalizedQuat * (offsetQuat * offsetQuat);
 		return normalizedQuat.normalized();
 	}
 
@@ -182,45 +188,124 @@ namespace Pivot {
 		mBaseArcball.resetQuat();
 		mPrevOrientation = mBaseArcball.getQuat();
 		mOrientationVel = Vec3f::zero();
+		mOrientationFilter.reset();
 	}
 
 
+	Quatf Trackball::getOrientation()
+	{
+		if ( mIsOrientationFiltered && mOrientationFilter.hasValue() ) return mOrientationFilter.getValue();
+		return calcBlendedOrientation();
+	}
+	
+	Quatf Trackball::calcBlendedOrientation()
+	{
+		if ( ! isFixedTimestep() ) return calcOrientation();
+		return mPrevStepOrientation.slerp( mStepAlpha, calcOrientation() );
+	}
+	
 	void Trackball::update( float deltaTime )
+	{
+		TouchObject::update( deltaTime );
+		
+		if ( mIsOrientationFiltered ) {
+			mFilterTime += deltaTime;
+			mOrientationFilter.filter( calcBlendedOrientation(), mFilterTime );
+		}
+	}
+	
+	void Trackball::enableOrientationFilter( float minCutoff, float beta, float derivativeCutoff )
+	{
+		mOrientationFilter = OneEuroFilter<Quatf>( minCutoff, beta, derivativeCutoff );
+		mIsOrientationFiltered = true;
+	}
+	
+	void Trackball::storePrevPose()
+	{
+		mPrevStepOrientation = calcOrientation();
+		mPrevStepRadius = mRadius;
+	}
+	
+	void Trackball::integrate( float deltaTime )
 	{
 		if ( mIsInMotion && mTouchPivot.numTouchPoints() < 2 ) {
 			
-			// velocity decay
-			float velDecay = math<float>::clamp( mVelDecay - ( mVelDecay * deltaTime ), 0.0f, 1.0f );
-			mOrientationVel *= velDecay;
-			mRotVel *= velDecay;
-			mScaleVel *= velDecay;
-			
-			// scale
-			//mScale += mScaleVel * elapsedTime;
-			//mRadius = mOriginRadius * mScale;
-			
-			// limit scale/radius
-			float prevRadius = mRadius;
-			mRadius = limit( mRadius, mReleaseRetraction, mMinRadius, mMaxRadius, deltaTime );
+			// exact for any deltaTime: advance by the distance the decaying velocities cover, then decay them
+			InertiaCurve inertia = getInertiaCurve();
+			float travel = inertia.getDistanceFactor( deltaTime );
 			
 			// "position"
 			if ( mTouchPivot.numTouchPoints() < 1 )
-				mBaseArcball.multQuat( Quatf( mOrientationVel.x * deltaTime, mOrientationVel.y * deltaTime, mOrientationVel.z * deltaTime ) );
+				mBaseArcball.coast( mOrientationVel * travel );
 			
 			// rotation
-			mRot += mRotVel * deltaTime;
+			mRot += mRotVel * travel;
 			
-			// check if motion noticable
-			if ( mOrientationVel.length() < 0.00001f && math<float>::abs( mRotVel ) < 0.00001f && math<float>::abs( mScaleVel ) < 0.0000001
-				&& math<float>::abs( mRadius - prevRadius ) < 0.001f ) {
-				mOrientationVel = Vec3f::zero();
-				mRotVel = 0.0f;
-				mScaleVel = 0.0f;
-				mIsInMotion = false;
-			}
+			float velDecay = inertia.getVelocityFactor( deltaTime );
+			mOrientationVel *= velDecay;
+			mRotVel *= velDecay;
+			mScaleVel *= velDecay;
+			
+			endStep( deltaTime );
 		}
 	}
+	
+	void Trackball::endStep( float deltaTime )
+	{
+		// limit scale/radius
+		float prevRadius = mRadius;
+		mRadius = limit( mRadius, mReleaseRetraction, mMinRadius, mMaxRadius, deltaTime );
+		if ( mRadius != prevRadius ) markBoundsDirty();
 		
+		// check if motion noticable
+		if ( mOrientationVel.length() < 0.00001f && math<float>::abs( mRotVel ) < 0.00001f && math<float>::abs( mScaleVel ) < 0.0000001
+			&& math<float>::abs( mRadius - prevRadius ) < 0.001f ) {
+			// coast the remainder too, so the trackball lands exactly on getRestOrientation()
+			float rest = getInertiaCurve().getRestFactor();
+			if ( mTouchPivot.numTouchPoints() < 1 )
+				mBaseArcball.coast( mOrientationVel * rest );
+			mRot += mRotVel * rest;
+			
+			mOrientationVel = Vec3f::zero();
+			mRotVel = 0.0f;
+			mScaleVel = 0.0f;
+			mIsInMotion = false;
+		}
+	}
+	
+	
+	Quatf Trackball::getOrientationAt( float time )
+	{
+		return calcCoastOrientation( getInertiaCurve().getDistanceFactor( time ) );
+	}
+	
+	Quatf Trackball::getRestOrientation()
+	{
+		return calcCoastOrientation( getInertiaCurve().getRestFactor() );
+	}
+	
+	float Trackball::getSettleTime()
+	{
+		fetchMomentum();
+		if ( ! mIsInMotion || mTouchPivot.numTouchPoints() > 1 ) return 0.0f;
+		
+		InertiaCurve inertia = getInertiaCurve();
+		float time = inertia.getSettleTime( mRotVel, 0.00001f );
+		if ( mTouchPivot.numTouchPoints() < 1 )
+			time = math<float>::max( time, inertia.getSettleTime( mOrientationVel.length(), 0.00001f ) );
+		return time;
+	}
+	
+	Quatf Trackball::calcCoastOrientation( float travel )
+	{
+		fetchMomentum();
+		if ( ! mIsInMotion || mTouchPivot.numTouchPoints() > 1 ) return calcOrientation();
+		
+		// same motion as integrate(), on a copy of the arcball
+		Trackball::Arcball arcball = mBaseArcball;
+		if ( mTouchPivot.numTouchPoints() < 1 )
+			arcball.coast( mOrientationVel * travel );
+		return calcOrientation( arcball, mRot + mRotVel * travel );
+	}
+	
 }
-
-
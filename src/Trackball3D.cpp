@@ -38,17 +38,28 @@ namespace Pivot {
 	using namespace ci::app;
 	using namespace std;
 	
-	Trackball3D::Trackball3D( Vec3f center, float radius, CameraPersp cam, bool captureTouches )
+	Trackball3D::Trackball3D( Vec3f center, float radius, const CameraPersp &cam, bool captureTouches )
 	: TouchObject3D( cam, captureTouches )
+	{
+		init( center, radius );
+	}
+	
+	Trackball3D::Trackball3D( Vec3f center, float radius, const CameraPersp &cam, const Vec2f &viewSize, bool captureTouches )
+	: TouchObject3D( cam, viewSize, captureTouches )
+	{
+		init( center, radius );
+	}
+	
+	void Trackball3D::init( Vec3f center, float radius )
 	{
 		mSphere = Sphere( center, radius );
 		mVelDecay = 0.99f;
 		mOriginRadius = mPivotResetRadius = mSphere.getRadius();
-		mOffsetQuat = Quatf( 0.0f, 0.0f, 0.0f, 1.0f );
-		mRotQuat = Quatf( 0.0f, 0.0f, 0.0f, 1.0f );
 		mPrevBaseAxis = Vec3f::zAxis();
+		mIsOrientationFiltered = false;
+		mFilterTime = 0.0;
 		reset();
-		mBaseArcball.setOrigin( Vec2f( mSphere.getCenter().x, mSphere.getCenter().y ), getOrientation(), mSphere, mCam, getWindowWidth(), getWindowHeight() ); // TODO: fix this ...................................
+		mBaseArcball.setOrigin( Vec2f( mSphere.getCenter().x, mSphere.getCenter().y ), calcOrientation(), mSphere, mProjection ); // TODO: fix this ...................................
 		mOrientationVel = Vec3f::zero();
 		
 		mMinRadius = 1.0f;
@@ -60,17 +71,36 @@ namespace Pivot {
 	
 	bool Trackball3D::hitTest( TouchEvent::Touch touch )
 	{
-		float u = touch.getPos().x / (float) getWindowWidth();
-		float v = touch.getPos().y / (float) getWindowHeight();
-		Ray ray = mCam.generateRay(u , 1.0f - v, mCam.getAspectRatio() );
+		Ray ray = mProjection.generateRay( touch.getPos() );
 		return mSphere.intersects( ray );
 	}
 	
+	bool Trackball3D::getBounds( Rectf *bounds )
+	{
+		// project the corners of the sphere's bounding cube. Unbounded if any are behind the near plane.
+		float r = mSphere.getRadius();
+		Vec3f c = mSphere.getCenter();
+		for ( int i = 0; i < 8; ++i ) {
+			Vec3f corner = c + Vec3f( ( i & 1 ) ? r : -r, ( i & 2 ) ? r : -r, ( i & 4 ) ? r : -r );
+			if ( mProjection.worldToEyeDepth( corner ) > -mProjection.getNearClip() ) return false;
+			Vec2f p = mProjection.worldToScreen( corner );
+			if ( i == 0 ) {
+				*bounds = Rectf( p.x, p.y, p.x, p.y );
+			} else {
+				bounds->x1 = math<float>::min( bounds->x1, p.x );
+				bounds->y1 = math<float>::min( bounds->y1, p.y );
+				bounds->x2 = math<float>::max( bounds->x2, p.x );
+				bounds->y2 = math<float>::max( bounds->y2, p.y );
+			}
+		}
+		return true;
+	}
+	
 	
 	void Trackball3D::pivotBegan( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mSphere.getRadius();
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mSphere, mCam, getWindowWidth(), getWindowHeight() );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mSphere, mProjection );
 		mRot = touchPivot->getRot();
 		mRotVel = 0.0f;
 		mPrevBaseAxis = mBaseArcball.getToAxis();
@@ -87,7 +117,7 @@ namespace Pivot {
 		// TODO: centerOffset
 		if ( touchPivot->numTouchPoints() > 1 ) {
 			mRot = touchPivot->getRot();
-			float maxRadius = mCam.getEyePoint().distance( mSphere.getCenter() ) - mCam.getNearClip();
+			float maxRadius = mProjection.getEyePoint().distance( mSphere.getCenter() ) - mProjection.getNearClip();
 			float radDistRatio = math<float>::clamp( mSphere.getRadius() / maxRadius, 0.0f, 1.0f );
 			float scaleOffset = ( 1.0f - touchPivot->getScale() ) * radDistRatio;
             
@@ -98,9 +128,10 @@ namespace Pivot {
             
             newRadius = limit( newRadius, mPullResistance, mMinRadius, mMaxRadius );
 			mSphere.setRadius( newRadius ); //////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			markBoundsDirty();
 		}
 
-		mBaseArcball.move( touchPivot->getPos(), mSphere, mCam, getWindowWidth(), getWindowHeight() );
+		mBaseArcball.move( touchPivot->getPos(), mSphere, mProjection );
 		
 		if ( mBaseArcball.getToAxis() != mPrevBaseAxis )
 			mBaseAxisDirection = mBaseArcball.getToAxis() - mPrevBaseAxis;
@@ -112,7 +143,7 @@ namespace Pivot {
 	void Trackball3D::pivotReset( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mSphere.getRadius();
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mSphere, mCam, getWindowWidth(), getWindowHeight() );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mSphere, mProjection );
 		mPrevBaseAxis = mBaseArcball.getToAxis();
 		mPrevOrientation = mBaseArcball.getQuat();
 		mRot = touchPivot->getRot();
@@ -132,7 +163,7 @@ namespace Pivot {
 	void Trackball3D::pivotEnded( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mSphere.getRadius();
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mSphere, mCam, getWindowWidth(), getWindowHeight() );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mSphere, mProjection );
 		mRot = touchPivot->getRot();
 
 		if ( mBaseArcball.getToAxis() != mPrevBaseAxis )
@@ -153,15 +184,15 @@ namespace Pivot {
 			mOrientationVel = Vec3f::zero();
 		} else {
 			// adjust thetaVel based on cam distance
-			float distToCam = mCam.getEyePoint().distance( mSphere.getCenter() );
+			float distToCam = mProjection.getEyePoint().distance( mSphere.getCenter() );
 			float radiusCamDistRatio = 1.0f - math<float>::min( 1.0f, mSphere.getRadius() / distToCam );
 			thetaVel *= radiusCamDistRatio;
 			// adjust thetaVel based on perspective
-			float eyeY 		= getWindowHeight() / 2.0f;
-			float halfFov 	= ( 3.14159f * mCam.getFov() ) / 360.0f;
+			float eyeY 		= mProjection.getViewSize().y / 2.0f;
+			float halfFov 	= ( 3.14159f * mProjection.getFov() ) / 360.0f;
 			float theTan 	= math<float>::tan( halfFov );
 			float focalDist = eyeY / theTan;
-			float camDepth	= -mCam.worldToEyeDepth( mSphere.getCenter() );
+			float camDepth	= -mProjection.worldToEyeDepth( mSphere.getCenter() );
 			float ratio = camDepth / focalDist;
 			thetaVel *= ratio;
 			
@@ -179,7 +210,7 @@ namespace Pivot {
 	void Trackball3D::pivotCancelled( TouchPivot *touchPivot )
 	{
 		mPivotResetRadius = mSphere.getRadius();
-		mBaseArcball.setOrigin( touchPivot->getPos(), getOrientation(), mSphere, mCam, getWindowWidth(), getWindowHeight() );
+		mBaseArcball.setOrigin( touchPivot->getPos(), calcOrientation(), mSphere, mProjection );
 		mPrevBaseAxis = mBaseArcball.getToAxis();
 		mRot = touchPivot->getRot();
 		mRotVel = 0.0f;
@@ -189,16 +220,15 @@ namespace Pivot {
 	
 	
 	// Dear community, I'm not very good with vector and quaternion math, can this be optimized?
-	Quatf Trackball3D::getOrientation() { 
+	Quatf Trackball3D::calcOrientation( const Trackball3D::Arcball3D &arcball, float rot ) const { 
 		// normalize to z axis
-		mOffsetQuat.set( mBaseArcball.getToAxis(), -Vec3f::zAxis() );
-		Quatf normalizedQuat = mBaseArcball.getQuat() * (mOffsetQuat * mOffsetQuat);
+		Quatf offsetQuat( arcball.getToAxis(), -Vec3f::zAxis() );
+		Quatf normalizedQuat = arcball.getQuat() * (offsetQuat * offsetQuat);
 		// rotate around z axis
-		mRotQuat.set( -Vec3f::zAxis(), mRot );
-		normalizedQuat = normalizedQuat * mRotQuat;
+		normalizedQuat = normalizedQuat * Quatf( -Vec3f::zAxis(), rot );
 		// restore orientation
-		mOffsetQuat.set( -Vec3f::zAxis(), mBaseArcball.getToAxis() );
-		normalizedQuat = normalizedQuat * (mOffsetQuat * mOffsetQuat);
+		offsetQuat.set( -Vec3f::zAxis(), arcball.getToAxis() );
+		normalizedQuat = normalizedQuat * (offsetQuat * offsetQuat);
 		return normalizedQuat.normalized();
 	}
 	
@@ -212,45 +242,124 @@ namespace Pivot {
 		mBaseArcball.resetQuat();
 		mPrevOrientation = mBaseArcball.getQuat();
 		mOrientationVel = Vec3f::zero();
+		mOrientationFilter.reset();
+	}
+	
+	
+	Quatf Trackball3D::getOrientation()
+	{
+		if ( mIsOrientationFiltered && mOrientationFilter.hasValue() ) return mOrientationFilter.getValue();
+		return calcBlendedOrientation();
 	}
 	
+	Quatf Trackball3D::calcBlendedOrientation()
+	{
+		if ( ! isFixedTimestep() ) return calcOrientation();
+		return mPrevStepOrientation.slerp( mStepAlpha, calcOrientation() );
+	}
 	
 	void Trackball3D::update( float deltaTime )
+	{
+		TouchObject::update( deltaTime );
+		
+		if ( mIsOrientationFiltered ) {
+			mFilterTime += deltaTime;
+			mOrientationFilter.filter( calcBlendedOrientation(), mFilterTime );
+		}
+	}
+	
+	void Trackball3D::enableOrientationFilter( float minCutoff, float beta, float derivativeCutoff )
+	{
+		mOrientationFilter = OneEuroFilter<Quatf>( minCutoff, beta, derivativeCutoff );
+		mIsOrientationFiltered = true;
+	}
+	
+	void Trackball3D::storePrevPose()
+	{
+		mPrevStepOrientation = calcOrientation();
+		mPrevStepRadius = mSphere.getRadius();
+	}
+	
+	void Trackball3D::integrate( float deltaTime )
 	{
 		if ( mIsInMotion && mTouchPivot.numTouchPoints() < 2 ) {
 			
-			// velocity decay
-			float velDecay = math<float>::clamp( mVelDecay - ( mVelDecay * deltaTime ), 0.0f, 1.0f );
-			mOrientationVel *= velDecay;
-			mRotVel *= velDecay;
-			mScaleVel *= velDecay;
-			
-			// scale
-			//mScale += mScaleVel * elapsedTime;
-			//mSphere.setRadius( mOriginRadius * mScale );
-			
-			// limit scale/radius
-			float prevRadius = mSphere.getRadius();
-			mSphere.setRadius( limit( prevRadius, mReleaseRetraction, mMinRadius, mMaxRadius, deltaTime ) );
+			// exact for any deltaTime: advance by the distance the decaying velocities cover, then decay them
+			InertiaCurve inertia = getInertiaCurve();
+			float travel = inertia.getDistanceFactor( deltaTime );
 			
 			// "position"
 			if ( mTouchPivot.numTouchPoints() < 1 )
-				mBaseArcball.multQuat( Quatf( mOrientationVel.x * deltaTime, mOrientationVel.y * deltaTime, mOrientationVel.z * deltaTime ) );
+				mBaseArcball.coast( mOrientationVel * travel );
 			
 			// rotation
-			mRot += mRotVel * deltaTime;
+			mRot += mRotVel * travel;
 			
-			// check if motion noticable
-			if ( mOrientationVel.length() < 0.00001f && math<float>::abs( mRotVel ) < 0.00001f && math<float>::abs( mScaleVel ) < 0.0000001
-				 && math<float>::abs( mSphere.getRadius() - prevRadius ) < 0.001f ) {
-				mOrientationVel = Vec3f::zero();
-				mRotVel = 0.0f;
-				mScaleVel = 0.0f;
-				mIsInMotion = false;
-			}
+			float velDecay = inertia.getVelocityFactor( deltaTime );
+			mOrientationVel *= velDecay;
+			mRotVel *= velDecay;
+			mScaleVel *= velDecay;
+			
+			endStep( deltaTime );
+		}
+	}
+	
+	void Trackball3D::endStep( float deltaTime )
+	{
+		// limit scale/radius
+		float prevRadius = mSphere.getRadius();
+		mSphere.setRadius( limit( prevRadius, mReleaseRetraction, mMinRadius, mMaxRadius, deltaTime ) );
+		if ( mSphere.getRadius() != prevRadius ) markBoundsDirty();
+		
+		// check if motion noticable
+		if ( mOrientationVel.length() < 0.00001f && math<float>::abs( mRotVel ) < 0.00001f && math<float>::abs( mScaleVel ) < 0.0000001
+			&& math<float>::abs( mSphere.getRadius() - prevRadius ) < 0.001f ) {
+			// coast the remainder too, so the trackball lands exactly on getRestOrientation()
+			float rest = getInertiaCurve().getRestFactor();
+			if ( mTouchPivot.numTouchPoints() < 1 )
+				mBaseArcball.coast( mOrientationVel * rest );
+			mRot += mRotVel * rest;
+			
+			mOrientationVel = Vec3f::zero();
+			mRotVel = 0.0f;
+			mScaleVel = 0.0f;
+			mIsInMotion = false;
 		}
 	}
 	
+	
+	Quatf Trackball3D::getOrientationAt( float time )
+	{
+		return calcCoastOrientation( getInertiaCurve().getDistanceFactor( time ) );
+	}
+	
+	Quatf Trackball3D::getRestOrientation()
+	{
+		return calcCoastOrientation( getInertiaCurve().getRestFactor() );
+	}
+	
+	float Trackball3D::getSettleTime()
+	{
+		fetchMomentum();
+		if ( ! mIsInMotion || mTouchPivot.numTouchPoints() > 1 ) return 0.0f;
+		
+		InertiaCurve inertia = getInertiaCurve();
+		float time = inertia.getSettleTime( mRotVel, 0.00001f );
+		if ( mTouchPivot.numTouchPoints() < 1 )
+			time = math<float>::max( time, inertia.getSettleTime( mOrientationVel.length(), 0.00001f ) );
+		return time;
+	}
+	
+	Quatf Trackball3D::calcCoastOrientation( float travel )
+	{
+		fetchMomentum();
+		if ( ! mIsInMotion || mTouchPivot.numTouchPoints() > 1 ) return calcOrientation();
+		
+		// same motion as integrate(), on a copy of the arcball
+		Trackball3D::Arcball3D arcball = mBaseArcball;
+		if ( mTouchPivot.numTouchPoints() < 1 )
+			arcball.coast( mOrientationVel * travel );
+		return calcOrientation( arcball, mRot + mRotVel * travel );
+	}
+	
 }
-
-
@@ -0,0 +1,131 @@
+/*
+ This code is designed for use with the Cinder C++ library, http://libcinder.org 
+ 
+ Copyright (c) 2012, Chris McKenzie
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice, this list of conditions and
+ the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+ the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ 
+ The views and conclusions contained in the software and documentation are those of the authors and should not
+ be interpreted as representing official policies, either expressed or implied, of the FreeBSD Project.
+ */
+
+#include "cinder/CinderMath.h"
+
+#include "VelocityEstimator.h"
+
+namespace Pivot {
+	
+	using namespace ci;
+	using namespace std;
+	
+	VelocityEstimator::VelocityEstimator( Mode mode, double window )
+	: mMode( mode ), mWindow( window ), mProcessNoise( 100000.0 ), mMeasurementNoise( 0.25 )
+	{
+		reset();
+	}
+	
+	void VelocityEstimator::reset()
+	{
+		mBaseTime = mBaseValue = mLastTime = 0.0;
+		mNumSamples = 0;
+		mHead = mSize = 0;
+		mSumT = mSumV = mSumTT = mSumTV = 0.0;
+		mPos = mVel = mCovPP = mCovPV = mCovVV = 0.0;
+	}
+	
+	void VelocityEstimator::addSample( double time, double value )
+	{
+		// a long pause means the motion before it says nothing about the motion after
+		if ( mNumSamples > 0 && ( time - mLastTime > mWindow || time < mLastTime ) ) reset();
+		
+		if ( mNumSamples == 0 ) {
+			mBaseTime = time;
+			mBaseValue = value;
+		}
+		double t = time - mBaseTime;
+		double v = value - mBaseValue;
+		
+		if ( mMode == LEAST_SQUARES ) {
+			if ( mSize == kCapacity ) removeOldest();
+			int slot = ( mHead + mSize ) % kCapacity;
+			mTimes[slot] = t;
+			mValues[slot] = v;
+			++mSize;
+			mSumT += t;
+			mSumV += v;
+			mSumTT += t * t;
+			mSumTV += t * v;
+			while( mSize > 1 && t - mTimes[mHead] > mWindow ) removeOldest();
+		} else {
+			if ( mNumSamples == 0 ) {
+				// velocity unknown: its variance is huge next to the measurement's
+				mPos = v;
+				mVel = 0.0;
+				mCovPP = mMeasurementNoise;
+				mCovPV = 0.0;
+				mCovVV = mMeasurementNoise * 1.0e8;
+			} else {
+				// predict
+				double dt = t - ( mLastTime - mBaseTime );
+				mPos += mVel * dt;
+				mCovPP += dt * ( 2.0 * mCovPV + dt * mCovVV ) + mProcessNoise * dt * dt * dt / 3.0;
+				mCovPV += dt * mCovVV + mProcessNoise * dt * dt / 2.0;
+				mCovVV += mProcessNoise * dt;
+				
+				// correct
+				double gainP = mCovPP / ( mCovPP + mMeasurementNoise );
+				double gainV = mCovPV / ( mCovPP + mMeasurementNoise );
+				double residual = v - mPos;
+				mPos += gainP * residual;
+				mVel += gainV * residual;
+				mCovVV -= gainV * mCovPV;
+				mCovPV *= 1.0 - gainP;
+				mCovPP *= 1.0 - gainP;
+			}
+		}
+		
+		mLastTime = time;
+		++mNumSamples;
+	}
+	
+	void VelocityEstimator::removeOldest()
+	{
+		double t = mTimes[mHead];
+		double v = mValues[mHead];
+		mSumT -= t;
+		mSumV -= v;
+		mSumTT -= t * t;
+		mSumTV -= t * v;
+		mHead = ( mHead + 1 ) % kCapacity;
+		--mSize;
+	}
+	
+	double VelocityEstimator::getVelocity() const
+	{
+		if ( mNumSamples < 2 ) return 0.0;
+		if ( mMode == KALMAN ) return mVel;
+		
+		if ( mSize < 2 ) return 0.0;
+		double n = mSize;
+		double denom = n * mSumTT - mSumT * mSumT;
+		if ( denom <= 1.0e-12 ) return 0.0;
+		return ( n * mSumTV - mSumT * mSumV ) / denom;
+	}
+	
+}